@@ -0,0 +1,198 @@
+// 수신 엔진 비교 벤치마크 (Asio vs io_uring)
+// 동일한 offered load를 loopback으로 보내고 syscalls/packet, CPU/packet을 측정한다.
+// syscalls는 엔진 자체 카운터가 아니라 커널 tracepoint(raw_syscalls:sys_enter)로
+// 수신 스레드가 실제로 진입한 시스템 콜을 센다 (epoll_wait / io_uring_enter 포함).
+// perf_event_paranoid 제한으로 열 수 없으면 n/a로 출력한다 (root 또는 CAP_PERFMON 필요).
+//
+// 사용법: recv-bench <asio|io_uring> [pps=200000] [seconds=5] [payload=512]
+
+#include "config.h"
+#include "lane_queue.h"
+#include "receiver_factory.h"
+#include <spdlog/spdlog.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// 한 스레드의 raw_syscalls:sys_enter 이벤트 수
+class SyscallCounter {
+public:
+    ~SyscallCounter() {
+        int fd = fd_.load();
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    // 측정할 스레드 안에서 호출
+    void open() {
+        long id = tracepoint_id();
+        if (id < 0) {
+            return;
+        }
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_TRACEPOINT;
+        attr.size = sizeof(attr);
+        attr.config = static_cast<uint64_t>(id);
+        int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+        fd_.store(fd);
+    }
+
+    // 측정 구간 시작 (소켓 / ring 준비 syscall 제외)
+    void reset() {
+        int fd = fd_.load();
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+
+    // 측정 불가면 -1
+    int64_t read() const {
+        int fd = fd_.load();
+        uint64_t value = 0;
+        if (fd < 0 || ::read(fd, &value, sizeof(value)) != sizeof(value)) {
+            return -1;
+        }
+        return static_cast<int64_t>(value);
+    }
+
+private:
+    static long tracepoint_id() {
+        for (const char* path : {"/sys/kernel/tracing/events/raw_syscalls/sys_enter/id",
+                                 "/sys/kernel/debug/tracing/events/raw_syscalls/sys_enter/id"}) {
+            std::ifstream in(path);
+            long id = -1;
+            if (in >> id) {
+                return id;
+            }
+        }
+        return -1;
+    }
+
+    std::atomic<int> fd_{-1};
+};
+
+// 지정한 pps로 loopback UDP 송신 (sendmmsg 32건 단위로 pacing)
+uint64_t run_sender(uint16_t port, uint64_t pps, int seconds, size_t payload_size) {
+    int fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+    std::string payload = R"({"stream":6,"function":11,"deviceId":1,"systemBytes":"0","body":{}})";
+    payload.resize(std::max(payload.size(), payload_size), ' ');
+
+    constexpr size_t kBurst = 32;
+    std::vector<iovec> iov(kBurst);
+    std::vector<mmsghdr> msgs(kBurst);
+    for (size_t i = 0; i < kBurst; ++i) {
+        iov[i].iov_base = payload.data();
+        iov[i].iov_len = payload.size();
+        msgs[i] = mmsghdr{};
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    auto interval = std::chrono::nanoseconds(1'000'000'000ull * kBurst / std::max<uint64_t>(pps, 1));
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+    auto next = start;
+    uint64_t sent = 0;
+
+    while (std::chrono::steady_clock::now() < end) {
+        int n = ::sendmmsg(fd, msgs.data(), kBurst, 0);
+        if (n > 0) {
+            sent += n;
+        }
+        next += interval;
+        std::this_thread::sleep_until(next);
+    }
+
+    ::close(fd);
+    return sent;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <asio|io_uring> [pps] [seconds] [payload]\n", argv[0]);
+        return 2;
+    }
+
+    spdlog::set_level(spdlog::level::warn);
+
+    auto config = secs::Config::from_env();
+    config.recv_backend = argv[1];
+    config.udp_host = "127.0.0.1";
+    uint64_t pps = argc > 2 ? std::stoull(argv[2]) : 200000;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 5;
+    size_t payload = argc > 4 ? std::stoul(argv[4]) : 512;
+
+    secs::LaneQueue queue(config.queue_lanes, config.queue_capacity);
+
+    // 워커 대신 큐를 비우기만 하는 소비자
+    std::atomic<bool> done{false};
+    std::thread drain([&queue, &done]() {
+        while (true) {
+            auto msg = queue.pop(std::chrono::milliseconds(100));
+            if (!msg && done) {
+                break;
+            }
+        }
+    });
+
+    secs::Ingress ingress(config, &queue);
+    auto receiver = secs::make_receiver(config, ingress);
+    SyscallCounter syscalls;
+    std::thread recv_thread([&receiver, &syscalls]() {
+        syscalls.open();
+        receiver->start();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    syscalls.reset();
+
+    uint64_t sent = run_sender(config.udp_port, pps, seconds, payload);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    receiver->stop();
+    recv_thread.join();
+    int64_t recv_syscalls = syscalls.read();
+    done = true;
+    queue.close();
+    drain.join();
+
+    uint64_t received = receiver->total_received();
+    double per_pkt = received ? 1.0 / received : 0.0;
+    char syscalls_per_pkt[32] = "n/a";
+    if (recv_syscalls >= 0) {
+        std::snprintf(syscalls_per_pkt, sizeof(syscalls_per_pkt), "%.4f", recv_syscalls * per_pkt);
+    }
+    std::printf("backend=%s offered_pps=%lu sent=%lu received=%lu loss=%.3f%% "
+                "syscalls/packet=%s cpu_ns/packet=%.1f kernel_drops=%lu queue_drops=%lu\n",
+                receiver->backend_name(),
+                static_cast<unsigned long>(pps),
+                static_cast<unsigned long>(sent),
+                static_cast<unsigned long>(received),
+                sent ? 100.0 * (sent - std::min(sent, received)) / sent : 0.0,
+                syscalls_per_pkt,
+                receiver->cpu_time_ns() * per_pkt,
+                static_cast<unsigned long>(ingress.tracker() ? ingress.tracker()->kernel_drops() : 0),
+                static_cast<unsigned long>(ingress.total_queue_drops()));
+    return 0;
+}
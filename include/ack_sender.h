@@ -0,0 +1,202 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "latency_histogram.h"
+#include "tracer.h"
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace secs {
+
+// S2F49 (W-bit) → S2F50 응답 송신
+//
+// S2F50_ACK = off | parse | commit
+//   parse : 파서가 S2F49를 검증한 직후 (DB 커밋을 기다리지 않음)
+//   commit: 배치가 모든 sink에 기록된 뒤 (커밋된 명령만 응답)
+// 응답은 수신 소켓(dup)으로 송신 주소에 보내며, systemBytes는 요청 값을 그대로 쓴다.
+// 본문은 미리 만든 템플릿에 deviceId / systemBytes만 채워 넣는다 (JSON DOM 생성 없음).
+//   {"stream":2,"function":50,"wbit":false,"deviceId":N,"systemBytes":"...",
+//    "body":{"type":"L","value":[{"type":"B","value":HCACK},{"type":"L","value":[]}]}}
+// 지연 = 수신 시각 → sendto 완료
+class AckSender {
+public:
+    enum class Mode { Off, Parse, Commit };
+
+    explicit AckSender(const Config& cfg)
+        : mode_(parse_mode(cfg.s2f50_ack))
+        , fd_(-1)
+        , sent_(0)
+        , failed_(0)
+        , skipped_(0)
+    {
+        prefix_ = R"({"stream":2,"function":50,"wbit":false,"deviceId":)";
+        middle_ = R"(,"systemBytes":")";
+        suffix_ = R"(","body":{"type":"L","value":[{"type":"B","value":)" +
+                  std::to_string(check_hcack(cfg.s2f50_hcack)) + R"(},{"type":"L","value":[]}]}})";
+    }
+
+    ~AckSender() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    AckSender(const AckSender&) = delete;
+    AckSender& operator=(const AckSender&) = delete;
+
+    Mode mode() const { return mode_; }
+    bool enabled() const { return mode_ != Mode::Off; }
+
+    // 수신 소켓 등록 (수신 엔진 start()에서 호출, 처음 등록된 소켓만 사용)
+    // dup으로 보관하므로 수신 엔진이 먼저 소켓을 닫아도 남은 배치의 응답을 보낼 수 있다.
+    void attach(int fd) {
+        if (!enabled()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(attach_mutex_);
+        if (fd_ >= 0) {
+            return;
+        }
+        int dup_fd = ::dup(fd);
+        if (dup_fd < 0) {
+            spdlog::error("S2F50 응답 소켓 준비 실패: {}", std::strerror(errno));
+            return;
+        }
+        fd_.store(dup_fd, std::memory_order_release);
+        spdlog::info("S2F50 자동 응답 활성 (mode={})", mode_name());
+    }
+
+    // 파싱 직후 (parse 모드)
+    void on_parsed(const RawMessage& raw, const ParsedMessage& parsed) {
+        if (mode_ == Mode::Parse) {
+            reply(raw, parsed);
+        }
+    }
+
+    // sink 기록 완료 후 (commit 모드)
+    void on_committed(const MessageBatch& batch) {
+        if (mode_ != Mode::Commit) {
+            return;
+        }
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (const auto& parsed = batch.parsed_messages[i]) {
+                reply(batch.raw_messages[i], *parsed);
+            }
+        }
+    }
+
+    json stats() const {
+        return {
+            {"mode", mode_name()},
+            {"sent", sent_.load()},
+            {"failed", failed_.load()},
+            {"skipped", skipped_.load()},
+            {"latency", latency_.stats()}
+        };
+    }
+
+private:
+    static Mode parse_mode(const std::string& s) {
+        if (s == "off" || s.empty()) {
+            return Mode::Off;
+        }
+        if (s == "parse") {
+            return Mode::Parse;
+        }
+        if (s == "commit") {
+            return Mode::Commit;
+        }
+        throw std::invalid_argument("S2F50_ACK는 off|parse|commit: " + s);
+    }
+
+    // HCACK은 B(1바이트) 아이템
+    static int check_hcack(int hcack) {
+        if (hcack < 0 || hcack > 255) {
+            throw std::invalid_argument("S2F50_HCACK는 0~255: " + std::to_string(hcack));
+        }
+        return hcack;
+    }
+
+    const char* mode_name() const {
+        switch (mode_) {
+            case Mode::Parse: return "parse";
+            case Mode::Commit: return "commit";
+            default: return "off";
+        }
+    }
+
+    // W-bit S2F49만 응답 (송신 주소 없음 = 캡처 재생 등 → 건너뜀)
+    void reply(const RawMessage& raw, const ParsedMessage& parsed) {
+        if (!parsed.wbit || parsed.stream != 2 || parsed.function != 49) {
+            return;
+        }
+        int fd = fd_.load(std::memory_order_acquire);
+        if (fd < 0 || raw.source.sin_family != AF_INET || !valid_system_bytes(parsed.system_bytes)) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        // 스레드별 송신 버퍼 재사용
+        thread_local std::string buf;
+        buf.assign(prefix_);
+        char num[16];
+        auto [end, ec] = std::to_chars(num, num + sizeof(num), parsed.device_id);
+        buf.append(num, end);
+        buf.append(middle_);
+        buf.append(parsed.system_bytes);
+        buf.append(suffix_);
+
+        ssize_t n = ::sendto(fd, buf.data(), buf.size(), MSG_DONTWAIT,
+                             reinterpret_cast<const sockaddr*>(&raw.source), sizeof(raw.source));
+        if (n < 0) {
+            // 소켓 송신 버퍼 부족 등 (재시도하지 않음, 호스트가 T3 타임아웃으로 재전송)
+            if (failed_.fetch_add(1, std::memory_order_relaxed) % 1000 == 0) {
+                spdlog::warn("S2F50 송신 실패 (장비 {}): {}", parsed.device_id, std::strerror(errno));
+            }
+            return;
+        }
+
+        sent_.fetch_add(1, std::memory_order_relaxed);
+        if (raw.recv_ns) {
+            latency_.record(Tracer::now_ns() - raw.recv_ns);
+        }
+    }
+
+    // 템플릿에 그대로 넣을 수 있는 값만 허용 (따옴표 / 이스케이프 없음)
+    static bool valid_system_bytes(const std::string& s) {
+        if (s.empty() || s.size() > 32) {
+            return false;
+        }
+        for (char c : s) {
+            if (!std::isalnum(static_cast<unsigned char>(c))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    Mode mode_;
+    std::string prefix_;
+    std::string middle_;
+    std::string suffix_;
+
+    std::mutex attach_mutex_;
+    std::atomic<int> fd_;
+    std::atomic<uint64_t> sent_;
+    std::atomic<uint64_t> failed_;
+    std::atomic<uint64_t> skipped_;
+    LatencyHistogram latency_;
+};
+
+} // namespace secs
@@ -0,0 +1,305 @@
+#pragma once
+
+#ifdef SECS_HAVE_ARROW
+
+#include "config.h"
+#include "message.h"
+#include "sink.h"
+#include "header_peek.h"
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/writer.h>
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace secs {
+
+inline void arrow_check(const arrow::Status& st) {
+    if (!st.ok()) {
+        throw std::runtime_error("Arrow 오류: " + st.ToString());
+    }
+}
+
+// 메시지 타입별 컬럼 버퍼 (device / carrier / 위치 컬럼은 dictionary 인코딩)
+namespace columns {
+
+using Int32Dict = arrow::DictionaryBuilder<arrow::Int32Type>;
+using ColumnList = std::vector<std::pair<const char*, arrow::ArrayBuilder*>>;
+
+struct S2F49 {
+    static constexpr const char* kTable = "s2f49_transfer_commands";
+
+    arrow::StringBuilder timestamp;
+    Int32Dict device_id;
+    arrow::StringBuilder system_bytes;
+    arrow::Int32Builder txn_code;
+    arrow::StringBuilder txn_id;
+    arrow::StringDictionaryBuilder command_type;
+    arrow::StringBuilder command_id;
+    arrow::Int32Builder priority;
+    arrow::StringDictionaryBuilder carrier_id;
+    arrow::StringDictionaryBuilder source;
+    arrow::StringDictionaryBuilder dest;
+    arrow::StringDictionaryBuilder source_type;
+    arrow::StringDictionaryBuilder dest_type;
+
+    ColumnList list() {
+        return {
+            {"timestamp", &timestamp}, {"device_id", &device_id}, {"system_bytes", &system_bytes},
+            {"txn_code", &txn_code}, {"txn_id", &txn_id}, {"command_type", &command_type},
+            {"command_id", &command_id}, {"priority", &priority}, {"carrier_id", &carrier_id},
+            {"source", &source}, {"dest", &dest}, {"source_type", &source_type},
+            {"dest_type", &dest_type}
+        };
+    }
+
+    void append(const S2F49Message& m) {
+        arrow_check(timestamp.Append(m.timestamp));
+        arrow_check(device_id.Append(m.device_id));
+        arrow_check(system_bytes.Append(m.system_bytes));
+        arrow_check(txn_code.Append(m.txn_code));
+        arrow_check(txn_id.Append(m.txn_id));
+        arrow_check(command_type.Append(m.command_type));
+        arrow_check(command_id.Append(m.command_id));
+        arrow_check(priority.Append(m.priority));
+        arrow_check(carrier_id.Append(m.carrier_id));
+        arrow_check(source.Append(m.source));
+        arrow_check(dest.Append(m.dest));
+        arrow_check(source_type.Append(m.source_type));
+        arrow_check(dest_type.Append(m.dest_type));
+    }
+};
+
+struct S6F11 {
+    static constexpr const char* kTable = "s6f11_event_reports";
+
+    arrow::StringBuilder timestamp;
+    Int32Dict device_id;
+    arrow::StringBuilder system_bytes;
+    arrow::Int32Builder event_report_id;
+    arrow::Int32Builder event_id;
+    arrow::StringBuilder data_items;  // JSON 배열
+
+    ColumnList list() {
+        return {
+            {"timestamp", &timestamp}, {"device_id", &device_id}, {"system_bytes", &system_bytes},
+            {"event_report_id", &event_report_id}, {"event_id", &event_id},
+            {"data_items", &data_items}
+        };
+    }
+
+    void append(const S6F11Message& m) {
+        arrow_check(timestamp.Append(m.timestamp));
+        arrow_check(device_id.Append(m.device_id));
+        arrow_check(system_bytes.Append(m.system_bytes));
+        arrow_check(event_report_id.Append(m.event_report_id));
+        arrow_check(event_id.Append(m.event_id));
+        arrow_check(data_items.Append(m.data_items.dump()));
+    }
+};
+
+// 파싱 대상이 아닌 메시지 (헤더 + body 원문)
+struct Raw {
+    static constexpr const char* kTable = "secs_raw_messages";
+
+    arrow::StringBuilder timestamp;
+    arrow::Int32Builder stream;
+    arrow::Int32Builder function;
+    arrow::BooleanBuilder wbit;
+    Int32Dict device_id;
+    arrow::StringBuilder system_bytes;
+    arrow::StringBuilder raw_body;
+
+    ColumnList list() {
+        return {
+            {"timestamp", &timestamp}, {"stream", &stream}, {"function", &function},
+            {"wbit", &wbit}, {"device_id", &device_id}, {"system_bytes", &system_bytes},
+            {"raw_body", &raw_body}
+        };
+    }
+
+    void append(const MessageHeader& h) {
+        arrow_check(timestamp.Append(h.timestamp));
+        arrow_check(stream.Append(h.stream));
+        arrow_check(function.Append(h.function));
+        arrow_check(wbit.Append(h.wbit));
+        arrow_check(device_id.Append(h.device_id));
+        arrow_check(system_bytes.Append(h.system_bytes));
+        arrow_check(raw_body.Append(h.body));
+    }
+};
+
+} // namespace columns
+
+// 시간 파티션 롤링 파일 1종 (테이블별)
+//   <ARROW_DIR>/<table>/dt=YYYY-MM-DD/hour=HH/part-w<worker>-<seq>.arrow
+// 파일 하나 = record batch 하나 → 파일 내 dictionary가 고정되어 IPC file 포맷과 호환
+template<typename Columns>
+class RollingArrowFile {
+public:
+    RollingArrowFile(const Config& cfg, size_t worker_id)
+        : config_(cfg)
+        , worker_id_(worker_id)
+    {}
+
+    Columns& open() {
+        if (!cols_) {
+            cols_ = std::make_unique<Columns>();
+            opened_ = std::chrono::system_clock::now();
+            partition_ = partition_of(opened_);
+        }
+        rows_++;
+        return *cols_;
+    }
+
+    // 롤링 조건 (행 수 / 경과 시간 / 시간 파티션 변경) 충족 시 파일 기록
+    void maybe_roll(bool force) {
+        if (rows_ == 0) {
+            return;
+        }
+        auto now = std::chrono::system_clock::now();
+        bool due = force
+            || rows_ >= config_.arrow_roll_rows
+            || now - opened_ >= std::chrono::seconds(config_.arrow_roll_sec)
+            || partition_of(now) != partition_;
+        if (due) {
+            write_file();
+        }
+    }
+
+    uint64_t bytes_written() const { return bytes_written_; }
+
+private:
+    static std::string partition_of(std::chrono::system_clock::time_point tp) {
+        std::time_t t = std::chrono::system_clock::to_time_t(tp);
+        std::tm tm{};
+        gmtime_r(&t, &tm);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "dt=%Y-%m-%d/hour=%H", &tm);
+        return buf;
+    }
+
+    void write_file() {
+        std::vector<std::shared_ptr<arrow::Field>> fields;
+        std::vector<std::shared_ptr<arrow::Array>> arrays;
+        for (auto& [name, builder] : cols_->list()) {
+            std::shared_ptr<arrow::Array> array;
+            arrow_check(builder->Finish(&array));
+            fields.push_back(arrow::field(name, array->type()));
+            arrays.push_back(std::move(array));
+        }
+        auto schema = arrow::schema(fields);
+        auto batch = arrow::RecordBatch::Make(schema, static_cast<int64_t>(rows_), arrays);
+
+        namespace fs = std::filesystem;
+        fs::path dir = fs::path(config_.arrow_dir) / Columns::kTable / partition_;
+        fs::create_directories(dir);
+        fs::path path = dir / ("part-w" + std::to_string(worker_id_) + "-" +
+                               std::to_string(seq_++) + ".arrow");
+        fs::path tmp = path;
+        tmp += ".inprogress";
+
+        {
+            auto out = arrow::io::FileOutputStream::Open(tmp.string());
+            arrow_check(out.status());
+            auto writer = arrow::ipc::MakeFileWriter(*out, schema);
+            arrow_check(writer.status());
+            arrow_check((*writer)->WriteRecordBatch(*batch));
+            arrow_check((*writer)->Close());
+            arrow_check((*out)->Close());
+        }
+        fs::rename(tmp, path);
+
+        bytes_written_ += fs::file_size(path);
+        spdlog::debug("Arrow 파일 기록: {} ({}건)", path.string(), rows_);
+
+        cols_.reset();
+        rows_ = 0;
+    }
+
+private:
+    const Config& config_;
+    size_t worker_id_;
+    std::unique_ptr<Columns> cols_;
+    size_t rows_ = 0;
+    uint64_t seq_ = 0;
+    uint64_t bytes_written_ = 0;
+    std::chrono::system_clock::time_point opened_;
+    std::string partition_;
+};
+
+// 메시지 타입별 Arrow IPC 파일 sink (DB 없이 단독 실행 가능)
+class ArrowIpcSink : public Sink {
+public:
+    ArrowIpcSink(const Config& cfg, size_t worker_id)
+        : s2f49_(cfg, worker_id)
+        , s6f11_(cfg, worker_id)
+        , raw_(cfg, worker_id)
+    {
+        spdlog::info("Arrow IPC sink: {} (roll {}건 / {}s)",
+                     cfg.arrow_dir, cfg.arrow_roll_rows, cfg.arrow_roll_sec);
+    }
+
+    ~ArrowIpcSink() override {
+        try {
+            flush();
+        }
+        catch (const std::exception& e) {
+            spdlog::error("Arrow sink 종료 flush 실패: {}", e.what());
+        }
+    }
+
+    const char* name() const override { return "arrow"; }
+
+    void write_batch(const MessageBatch& batch) override {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const auto& parsed = batch.parsed_messages[i];
+            if (auto s2f49 = std::dynamic_pointer_cast<S2F49Message>(parsed)) {
+                s2f49_.open().append(*s2f49);
+            }
+            else if (auto s6f11 = std::dynamic_pointer_cast<S6F11Message>(parsed)) {
+                s6f11_.open().append(*s6f11);
+            }
+            else {
+                const auto& raw = batch.raw_messages[i];
+                if (auto hdr = HeaderPeek::peek(raw.bytes(), raw.size())) {
+                    raw_.open().append(*hdr);
+                }
+            }
+        }
+        total_written_ += batch.size();
+
+        s2f49_.maybe_roll(false);
+        s6f11_.maybe_roll(false);
+        raw_.maybe_roll(false);
+    }
+
+    void flush() override {
+        s2f49_.maybe_roll(true);
+        s6f11_.maybe_roll(true);
+        raw_.maybe_roll(true);
+    }
+
+    uint64_t total_written() const override { return total_written_; }
+
+    uint64_t bytes_written() const override {
+        return s2f49_.bytes_written() + s6f11_.bytes_written() + raw_.bytes_written();
+    }
+
+private:
+    RollingArrowFile<columns::S2F49> s2f49_;
+    RollingArrowFile<columns::S6F11> s6f11_;
+    RollingArrowFile<columns::Raw> raw_;
+    uint64_t total_written_ = 0;
+};
+
+} // namespace secs
+
+#endif // SECS_HAVE_ARROW
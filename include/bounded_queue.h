@@ -70,6 +70,18 @@ public:
         return queue_.size();
     }
 
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return capacity_;
+    }
+
+    // 런타임 용량 변경 (줄여도 이미 들어있는 아이템은 유지, 비워질 때까지 push만 막힘)
+    void set_capacity(size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = capacity;
+        not_full_.notify_all();
+    }
+
     // 큐 닫기 (더 이상 push 불가)
     void close() {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -79,7 +91,7 @@ public:
     }
 
 private:
-    const size_t capacity_;
+    size_t capacity_;
     std::queue<T> queue_;
     mutable std::mutex mutex_;
     std::condition_variable not_empty_;
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace secs {
+
+// 캡처 파일에서 꺼낸 데이터그램 1건 (mmap 영역을 가리킴, 복사 없음)
+struct CaptureRecord {
+    const uint8_t* data;
+    size_t len;
+    int64_t ts_ns;   // 캡처 시각 (raw 포맷은 타임스탬프 없음 → has_ts=false)
+    bool has_ts;
+};
+
+// 캡처 파일 리더 (mmap 기반)
+//
+// 지원 포맷
+//   pcap : libpcap 클래식 포맷 (us/ns 정밀도, 양쪽 엔디언)
+//          linktype Ethernet(1), Raw IP(101), Linux SLL(113), Linux SLL2(276), BSD loopback(0)
+//          IPv4/UDP 페이로드만 추출 (IP 단편은 건너뜀)
+//   raw  : [u32 little-endian 길이][데이터그램 바이트] 반복
+class CaptureReader {
+public:
+    enum class Format { Pcap, Raw };
+
+    // format: "auto" | "pcap" | "raw", filter_port: 0이면 모든 UDP 포트
+    CaptureReader(const std::string& path, const std::string& format, uint16_t filter_port)
+        : filter_port_(filter_port)
+    {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error("캡처 파일 열기 실패: " + path + " (" + std::strerror(errno) + ")");
+        }
+
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("캡처 파일 stat 실패: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("캡처 파일 mmap 실패: " + path);
+            }
+            base_ = static_cast<const uint8_t*>(p);
+            // 순차 읽기 → 커널 readahead 최대화
+            // (MADV_*는 비트 플래그가 아닌 advice 값이므로 호출을 나눈다, 실패해도 읽기는 가능)
+            if (::madvise(p, size_, MADV_SEQUENTIAL) != 0) {
+                spdlog::warn("캡처 파일 madvise(SEQUENTIAL) 실패: {} ({})", path, std::strerror(errno));
+            }
+            if (::madvise(p, size_, MADV_WILLNEED) != 0) {
+                spdlog::warn("캡처 파일 madvise(WILLNEED) 실패: {} ({})", path, std::strerror(errno));
+            }
+        }
+
+        format_ = detect_format(format);
+        if (format_ == Format::Pcap) {
+            read_pcap_header();
+        }
+    }
+
+    ~CaptureReader() {
+        if (base_) {
+            ::munmap(const_cast<uint8_t*>(base_), size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    Format format() const { return format_; }
+    size_t file_size() const { return size_; }
+    size_t offset() const { return offset_; }
+    uint64_t skipped() const { return skipped_; }
+
+    // 다음 데이터그램 (파일 끝이면 nullopt)
+    std::optional<CaptureRecord> next() {
+        return format_ == Format::Pcap ? next_pcap() : next_raw();
+    }
+
+private:
+    static constexpr uint32_t kPcapMagicUs = 0xa1b2c3d4;
+    static constexpr uint32_t kPcapMagicNs = 0xa1b23c4d;
+
+    Format detect_format(const std::string& format) const {
+        if (format == "pcap") return Format::Pcap;
+        if (format == "raw") return Format::Raw;
+
+        if (size_ >= 4) {
+            uint32_t magic;
+            std::memcpy(&magic, base_, 4);
+            if (magic == kPcapMagicUs || magic == kPcapMagicNs ||
+                __builtin_bswap32(magic) == kPcapMagicUs ||
+                __builtin_bswap32(magic) == kPcapMagicNs) {
+                return Format::Pcap;
+            }
+        }
+        return Format::Raw;
+    }
+
+    void read_pcap_header() {
+        if (size_ < 24) {
+            throw std::runtime_error("pcap 헤더가 잘림");
+        }
+        uint32_t magic;
+        std::memcpy(&magic, base_, 4);
+        swapped_ = (magic != kPcapMagicUs && magic != kPcapMagicNs);
+        uint32_t native = swapped_ ? __builtin_bswap32(magic) : magic;
+        if (native != kPcapMagicUs && native != kPcapMagicNs) {
+            throw std::runtime_error("pcap magic 불일치");
+        }
+        nanosecond_ = (native == kPcapMagicNs);
+        linktype_ = u32(base_ + 20);
+        offset_ = 24;
+    }
+
+    std::optional<CaptureRecord> next_raw() {
+        while (offset_ + 4 <= size_) {
+            uint32_t len;
+            std::memcpy(&len, base_ + offset_, 4);
+            offset_ += 4;
+            if (offset_ + len > size_) {
+                // 마지막 레코드 잘림
+                skipped_++;
+                offset_ = size_;
+                break;
+            }
+            CaptureRecord rec{base_ + offset_, len, 0, false};
+            offset_ += len;
+            return rec;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<CaptureRecord> next_pcap() {
+        while (offset_ + 16 <= size_) {
+            const uint8_t* hdr = base_ + offset_;
+            uint32_t ts_sec = u32(hdr);
+            uint32_t ts_frac = u32(hdr + 4);
+            uint32_t incl_len = u32(hdr + 8);
+            offset_ += 16;
+
+            if (offset_ + incl_len > size_) {
+                skipped_++;
+                offset_ = size_;
+                break;
+            }
+            const uint8_t* pkt = base_ + offset_;
+            offset_ += incl_len;
+
+            int64_t ts_ns = int64_t(ts_sec) * 1'000'000'000 +
+                            (nanosecond_ ? int64_t(ts_frac) : int64_t(ts_frac) * 1000);
+
+            const uint8_t* payload = nullptr;
+            size_t payload_len = 0;
+            if (extract_udp(pkt, incl_len, payload, payload_len)) {
+                return CaptureRecord{payload, payload_len, ts_ns, true};
+            }
+            skipped_++;
+        }
+        return std::nullopt;
+    }
+
+    // 링크 계층 → IPv4 → UDP 페이로드
+    bool extract_udp(const uint8_t* pkt, size_t len, const uint8_t*& payload, size_t& payload_len) const {
+        size_t off = 0;
+        uint16_t ethertype = 0x0800;
+
+        switch (linktype_) {
+        case 1:  // Ethernet
+            if (len < 14) return false;
+            ethertype = be16(pkt + 12);
+            off = 14;
+            while ((ethertype == 0x8100 || ethertype == 0x88a8) && off + 4 <= len) {
+                ethertype = be16(pkt + off + 2);
+                off += 4;
+            }
+            break;
+        case 113:  // Linux cooked (SLL)
+            if (len < 16) return false;
+            ethertype = be16(pkt + 14);
+            off = 16;
+            break;
+        case 276:  // Linux cooked v2 (SLL2)
+            if (len < 20) return false;
+            ethertype = be16(pkt);
+            off = 20;
+            break;
+        case 0:  // BSD loopback (호스트 엔디언 family)
+            if (len < 4) return false;
+            off = 4;
+            break;
+        case 101:  // Raw IP
+        case 12:
+            break;
+        default:
+            return false;
+        }
+
+        if (ethertype != 0x0800 || off + 20 > len) {
+            return false;
+        }
+
+        const uint8_t* ip = pkt + off;
+        if ((ip[0] >> 4) != 4 || ip[9] != 17) {  // IPv4 / UDP
+            return false;
+        }
+        size_t ihl = size_t(ip[0] & 0x0f) * 4;
+        uint16_t frag = be16(ip + 6);
+        if ((frag & 0x3fff) != 0) {  // MF 플래그 또는 fragment offset
+            return false;
+        }
+        size_t ip_total = be16(ip + 2);
+        if (ihl < 20 || off + ip_total > len || ip_total < ihl + 8) {
+            return false;
+        }
+
+        const uint8_t* udp = ip + ihl;
+        if (filter_port_ != 0 && be16(udp + 2) != filter_port_) {
+            return false;
+        }
+        size_t udp_len = be16(udp + 4);
+        if (udp_len < 8 || ihl + udp_len > ip_total) {
+            return false;
+        }
+
+        payload = udp + 8;
+        payload_len = udp_len - 8;
+        return true;
+    }
+
+    uint32_t u32(const uint8_t* p) const {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return swapped_ ? __builtin_bswap32(v) : v;
+    }
+
+    static uint16_t be16(const uint8_t* p) {
+        return static_cast<uint16_t>((p[0] << 8) | p[1]);
+    }
+
+private:
+    int fd_ = -1;
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    size_t offset_ = 0;
+    uint16_t filter_port_;
+
+    Format format_ = Format::Raw;
+    bool swapped_ = false;
+    bool nanosecond_ = false;
+    uint32_t linktype_ = 1;
+    uint64_t skipped_ = 0;
+};
+
+} // namespace secs
@@ -0,0 +1,359 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include <spdlog/spdlog.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace secs {
+
+// 캐리어 / 반송 명령 최신 상태 캐시
+//
+// S2F49 파싱 시점에 갱신되는 메모리 인덱스
+//   carrier_id → 마지막 반송 명령 (위치: source → dest)
+//   command_id → 명령 상태 (received → committed)
+// 로컬 query 소켓에서 조회하고, 주기적으로 스냅샷 파일에 저장하여 재시작 시 복원한다.
+class CarrierStateCache {
+public:
+    struct CommandState {
+        std::string command_id;
+        std::string carrier_id;
+        std::string command_type;
+        std::string source;
+        std::string dest;
+        std::string source_type;
+        std::string dest_type;
+        int priority = 0;
+        int device_id = 0;
+        std::string timestamp;
+        std::string system_bytes;
+        bool committed = false;  // DB 커밋 완료 여부
+    };
+
+    explicit CarrierStateCache(const Config& cfg)
+        : config_(cfg)
+        , running_(false)
+        , total_updates_(0)
+    {}
+
+    ~CarrierStateCache() {
+        stop();
+    }
+
+    // 스냅샷 복원 + 스냅샷 스레드 시작
+    void start() {
+        if (!config_.state_snapshot_path.empty()) {
+            load_snapshot();
+            running_ = true;
+            snapshot_thread_ = std::thread([this]() { snapshot_main(); });
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        snapshot_cv_.notify_all();
+        if (snapshot_thread_.joinable()) {
+            snapshot_thread_.join();
+        }
+        save_snapshot();
+    }
+
+    // 워커 스레드에서 호출 (파싱 직후)
+    void update(const S2F49Message& msg) {
+        CommandState state;
+        state.command_id = msg.command_id;
+        state.carrier_id = msg.carrier_id;
+        state.command_type = msg.command_type;
+        state.source = msg.source;
+        state.dest = msg.dest;
+        state.source_type = msg.source_type;
+        state.dest_type = msg.dest_type;
+        state.priority = msg.priority;
+        state.device_id = msg.device_id;
+        state.timestamp = msg.timestamp;
+        state.system_bytes = msg.system_bytes;
+        apply(std::move(state));
+        total_updates_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // DB 커밋 이후 호출
+    void mark_committed(const S2F49Message& msg) {
+        if (!msg.carrier_id.empty()) {
+            auto& shard = carrier_shard(msg.carrier_id);
+            std::unique_lock lock(shard.mutex);
+            auto it = shard.carriers.find(msg.carrier_id);
+            if (it != shard.carriers.end() && it->second.command_id == msg.command_id &&
+                it->second.timestamp == msg.timestamp) {
+                it->second.committed = true;
+            }
+        }
+        if (!msg.command_id.empty()) {
+            auto& shard = command_shard(msg.command_id);
+            std::unique_lock lock(shard.mutex);
+            auto it = shard.commands.find(msg.command_id);
+            if (it != shard.commands.end() && it->second.timestamp == msg.timestamp) {
+                it->second.committed = true;
+            }
+        }
+    }
+
+    std::optional<CommandState> find_carrier(const std::string& carrier_id) const {
+        const auto& shard = carrier_shard(carrier_id);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.carriers.find(carrier_id);
+        if (it == shard.carriers.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    std::optional<CommandState> find_command(const std::string& command_id) const {
+        const auto& shard = command_shard(command_id);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.commands.find(command_id);
+        if (it == shard.commands.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    static json to_json(const CommandState& s) {
+        return {
+            {"command_id", s.command_id},
+            {"carrier_id", s.carrier_id},
+            {"command_type", s.command_type},
+            {"source", s.source},
+            {"dest", s.dest},
+            {"source_type", s.source_type},
+            {"dest_type", s.dest_type},
+            {"priority", s.priority},
+            {"device_id", s.device_id},
+            {"timestamp", s.timestamp},
+            {"system_bytes", s.system_bytes},
+            {"state", s.committed ? "committed" : "received"}
+        };
+    }
+
+    json stats() const {
+        size_t carriers = 0;
+        size_t commands = 0;
+        for (const auto& shard : carrier_shards_) {
+            std::shared_lock lock(shard.mutex);
+            carriers += shard.carriers.size();
+        }
+        for (const auto& shard : command_shards_) {
+            std::shared_lock lock(shard.mutex);
+            commands += shard.commands.size();
+        }
+        return {
+            {"carriers", carriers},
+            {"commands", commands},
+            {"updates", total_updates_.load()}
+        };
+    }
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct CarrierShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, CommandState> carriers;
+    };
+
+    struct CommandShard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, CommandState> commands;
+        std::deque<std::string> order;  // 삽입 순서 (오래된 명령부터 제거)
+    };
+
+    CarrierShard& carrier_shard(const std::string& key) {
+        return carrier_shards_[std::hash<std::string>()(key) % kShards];
+    }
+    const CarrierShard& carrier_shard(const std::string& key) const {
+        return carrier_shards_[std::hash<std::string>()(key) % kShards];
+    }
+    CommandShard& command_shard(const std::string& key) {
+        return command_shards_[std::hash<std::string>()(key) % kShards];
+    }
+    const CommandShard& command_shard(const std::string& key) const {
+        return command_shards_[std::hash<std::string>()(key) % kShards];
+    }
+
+    // 워커 간 처리 순서가 뒤바뀔 수 있으므로 timestamp가 더 최신인 경우에만 교체
+    // (ISO-8601 문자열은 사전순 비교 = 시간순 비교)
+    void apply(CommandState state) {
+        if (!state.carrier_id.empty()) {
+            auto& shard = carrier_shard(state.carrier_id);
+            std::unique_lock lock(shard.mutex);
+            auto [it, inserted] = shard.carriers.try_emplace(state.carrier_id, state);
+            if (!inserted && it->second.timestamp <= state.timestamp) {
+                it->second = state;
+            }
+        }
+
+        if (!state.command_id.empty()) {
+            auto& shard = command_shard(state.command_id);
+            std::unique_lock lock(shard.mutex);
+            auto [it, inserted] = shard.commands.try_emplace(state.command_id, state);
+            if (inserted) {
+                shard.order.push_back(state.command_id);
+                size_t limit = std::max<size_t>(config_.state_max_commands / kShards, 1);
+                while (shard.commands.size() > limit && !shard.order.empty()) {
+                    shard.commands.erase(shard.order.front());
+                    shard.order.pop_front();
+                }
+            } else if (it->second.timestamp <= state.timestamp) {
+                it->second = std::move(state);
+            }
+        }
+    }
+
+    void snapshot_main() {
+        while (true) {
+            std::unique_lock<std::mutex> lock(snapshot_mutex_);
+            snapshot_cv_.wait_for(lock, std::chrono::seconds(config_.state_snapshot_sec),
+                                  [this] { return !running_; });
+            if (!running_) {
+                break;
+            }
+            lock.unlock();
+            save_snapshot();
+        }
+    }
+
+    // 스냅샷: JSON lines ({"k":"carrier"|"command", ...}), 임시 파일에 쓴 뒤 rename
+    void save_snapshot() const {
+        if (config_.state_snapshot_path.empty()) {
+            return;
+        }
+
+        std::string tmp_path = config_.state_snapshot_path + ".tmp";
+        std::ofstream out(tmp_path, std::ios::trunc);
+        if (!out) {
+            spdlog::error("상태 스냅샷 파일 열기 실패: {}", tmp_path);
+            return;
+        }
+
+        // 샤드 단위로 잠금 안에서 복사만 하고, 직렬화 / 파일 쓰기는 잠금 밖에서
+        // (워커의 update / mark_committed가 디스크 쓰기를 기다리지 않도록)
+        size_t rows = 0;
+        std::vector<CommandState> copy;
+        auto write = [&](const char* kind) {
+            for (const auto& s : copy) {
+                json j = to_json(s);
+                j["k"] = kind;
+                out << j.dump() << '\n';
+            }
+            rows += copy.size();
+            copy.clear();
+        };
+
+        for (const auto& shard : carrier_shards_) {
+            {
+                std::shared_lock lock(shard.mutex);
+                copy.reserve(shard.carriers.size());
+                for (const auto& [_, s] : shard.carriers) {
+                    copy.push_back(s);
+                }
+            }
+            write("carrier");
+        }
+        for (const auto& shard : command_shards_) {
+            {
+                std::shared_lock lock(shard.mutex);
+                copy.reserve(shard.order.size());
+                for (const auto& id : shard.order) {
+                    copy.push_back(shard.commands.at(id));
+                }
+            }
+            write("command");
+        }
+
+        out.close();
+        if (!out || std::rename(tmp_path.c_str(), config_.state_snapshot_path.c_str()) != 0) {
+            spdlog::error("상태 스냅샷 저장 실패: {}", config_.state_snapshot_path);
+            return;
+        }
+        spdlog::debug("상태 스냅샷 저장: {}건", rows);
+    }
+
+    void load_snapshot() {
+        std::ifstream in(config_.state_snapshot_path);
+        if (!in) {
+            return;  // 첫 실행
+        }
+
+        size_t rows = 0;
+        for (std::string line; std::getline(in, line);) {
+            try {
+                json j = json::parse(line);
+                CommandState s;
+                s.command_id = j.value("command_id", "");
+                s.carrier_id = j.value("carrier_id", "");
+                s.command_type = j.value("command_type", "");
+                s.source = j.value("source", "");
+                s.dest = j.value("dest", "");
+                s.source_type = j.value("source_type", "");
+                s.dest_type = j.value("dest_type", "");
+                s.priority = j.value("priority", 0);
+                s.device_id = j.value("device_id", 0);
+                s.timestamp = j.value("timestamp", "");
+                s.system_bytes = j.value("system_bytes", "");
+                s.committed = j.value("state", "") == "committed";
+
+                // carrier 행은 carrier 인덱스만, command 행은 command 인덱스만 복원
+                if (j.value("k", "") == "carrier") {
+                    auto& shard = carrier_shard(s.carrier_id);
+                    std::unique_lock lock(shard.mutex);
+                    shard.carriers[s.carrier_id] = std::move(s);
+                } else {
+                    auto& shard = command_shard(s.command_id);
+                    std::unique_lock lock(shard.mutex);
+                    if (shard.commands.emplace(s.command_id, s).second) {
+                        shard.order.push_back(s.command_id);
+                    }
+                }
+                rows++;
+            }
+            catch (const json::exception& e) {
+                spdlog::warn("상태 스냅샷 행 무시: {}", e.what());
+            }
+        }
+        spdlog::info("상태 스냅샷 복원: {} ({}건)", config_.state_snapshot_path, rows);
+    }
+
+private:
+    const Config& config_;
+
+    std::array<CarrierShard, kShards> carrier_shards_;
+    std::array<CommandShard, kShards> command_shards_;
+
+    std::mutex snapshot_mutex_;
+    std::condition_variable snapshot_cv_;
+    bool running_;
+    std::thread snapshot_thread_;
+
+    std::atomic<uint64_t> total_updates_;
+};
+
+} // namespace secs
@@ -13,18 +13,78 @@ struct Config {
     std::string db_name;
     std::string db_user;
     std::string db_password;
-    size_t db_pool_size;
+    size_t db_pool_size;          // 샤딩 시 샤드별 writer connection 수
+    std::string db_targets;       // "host:port[/dbname],..." (설정 시 deviceId 샤딩)
+    std::string db_shard_map;     // "deviceId=shard,..." (해시 대신 고정 배치)
+    size_t db_shard_queue;        // 샤드별 대기 하위 배치 상한
+    std::string raw_retention;       // (stream, function)별 raw 보관 정책
+    size_t raw_compress_level;       // 0 = 압축 안함, 1~9 = zlib 레벨
+    size_t raw_compress_min_bytes;   // 이보다 작은 body는 압축하지 않음
 
     // UDP
     std::string udp_host;
     uint16_t udp_port;
+    std::string recv_backend;     // "asio" | "io_uring"
+    size_t uring_entries;
+    size_t uring_buf_count;       // 2의 거듭제곱
+    size_t uring_buf_size;        // 버퍼당 최대 데이터그램 크기 (헤더 공간 별도)
+    bool seq_tracking;            // deviceId별 systemBytes 시퀀스 추적 (손실 분석)
+    int system_bytes_base;        // systemBytes 문자열 진법 (16 | 10)
+    size_t rate_limit_per_sec;    // deviceId별 초당 허용 건수 (0 = 제한 없음)
+    size_t rate_limit_burst;      // 순간 허용 건수 (0 = rate와 동일)
+    std::string rate_limit_overrides;  // "deviceId=rate[/burst],..."
+    size_t rate_limit_table_size; // 추적 장비 수 상한
+    std::string s2f50_ack;        // W-bit S2F49 자동 응답: "off" | "parse" | "commit"
+    int s2f50_hcack;              // 응답 HCACK 값
+
+    // Replay (설정 시 UDP 소켓 대신 캡처 파일 입력)
+    std::string replay_file;
+    std::string replay_format;    // "auto" | "pcap" | "raw"
+    double replay_speed;          // 0 = 최대 속도, 1.0 = 원본 간격
+    uint16_t replay_filter_port;  // pcap UDP 목적지 포트 필터 (0 = 전체)
+
+    // Sinks ("postgres", "arrow", "null" 중 쉼표 구분)
+    std::string sinks;
+    std::string arrow_dir;
+    size_t arrow_roll_rows;
+    size_t arrow_roll_sec;
+    std::string shm_ring_name;    // shm sink: POSIX shm 이름 (/dev/shm 아래)
+    size_t shm_ring_slots;        // 2의 거듭제곱
+    size_t shm_ring_slot_size;    // 레코드 + payload (64의 배수)
+    unsigned shm_ring_mode;       // shm 객체 권한 (8진수)
+
+    // Routing (헤더 기반 drop / raw / parse 규칙)
+    std::string route_rules;
+
+    // S6F11 rollup (윈도우 0이면 비활성)
+    size_t rollup_window_sec;
+    size_t rollup_flush_ms;
+    size_t rollup_grace_sec;      // 윈도우 종료 후 늦은 이벤트 대기 시간
+    size_t rollup_max_pending;    // DB 장애 시 보류할 최대 rollup row 수
+
+    // Carrier state cache (QUERY_SOCKET 설정 시 활성)
+    std::string query_socket;
+    std::string state_snapshot_path;  // 빈 값이면 스냅샷 안함
+    size_t state_snapshot_sec;
+    size_t state_max_commands;
 
     // Performance
+    std::string exec_mode;        // "pipeline" (수신 → 큐 → 워커) | "per_core"
+    size_t core_count;            // per_core 스레드 수 (0 = CPU 수)
     size_t queue_capacity;
+    std::string queue_lanes;      // 우선순위 lane 정의 (lane_queue.h 참고)
     size_t worker_count;
     size_t batch_size;
     size_t batch_timeout_ms;
 
+    // Control (빈 값이면 비활성)
+    std::string control_socket;
+
+    // Tracing (SIGUSR1 / 제어 명령으로 Chrome trace JSON 저장)
+    bool trace_enabled;
+    size_t trace_buffer_events;   // 스레드별 ring 크기
+    std::string trace_dir;
+
     static Config from_env() {
         Config cfg;
         
@@ -35,17 +95,77 @@ struct Config {
         cfg.db_user = getenv_or("DB_USER", "secs_user");
         cfg.db_password = getenv_or("DB_PASSWORD", "secspass");
         cfg.db_pool_size = std::stoul(getenv_or("DB_POOL_SIZE", "4"));
+        cfg.db_targets = getenv_or("DB_TARGETS", "");
+        cfg.db_shard_map = getenv_or("DB_SHARD_MAP", "");
+        cfg.db_shard_queue = std::stoul(getenv_or("DB_SHARD_QUEUE", "10000"));
+        cfg.raw_retention = getenv_or("RAW_RETENTION", "default=full");
+        cfg.raw_compress_level = std::stoul(getenv_or("RAW_COMPRESS_LEVEL", "0"));
+        cfg.raw_compress_min_bytes = std::stoul(getenv_or("RAW_COMPRESS_MIN_BYTES", "256"));
 
         // UDP
         cfg.udp_host = getenv_or("UDP_HOST", "0.0.0.0");
         cfg.udp_port = std::stoi(getenv_or("UDP_PORT", "5000"));
+        cfg.recv_backend = getenv_or("RECV_BACKEND", "asio");
+        cfg.uring_entries = std::stoul(getenv_or("URING_ENTRIES", "256"));
+        cfg.uring_buf_count = std::stoul(getenv_or("URING_BUF_COUNT", "4096"));
+        cfg.uring_buf_size = std::stoul(getenv_or("URING_BUF_SIZE", "65536"));
+        cfg.seq_tracking = getenv_or("SEQ_TRACKING", "0") != "0";
+        cfg.system_bytes_base = std::stoi(getenv_or("SYSTEM_BYTES_BASE", "16"));
+        cfg.rate_limit_per_sec = std::stoul(getenv_or("RATE_LIMIT_PER_SEC", "0"));
+        cfg.rate_limit_burst = std::stoul(getenv_or("RATE_LIMIT_BURST", "0"));
+        cfg.rate_limit_overrides = getenv_or("RATE_LIMIT_OVERRIDES", "");
+        cfg.rate_limit_table_size = std::stoul(getenv_or("RATE_LIMIT_TABLE_SIZE", "4096"));
+        cfg.s2f50_ack = getenv_or("S2F50_ACK", "off");
+        cfg.s2f50_hcack = std::stoi(getenv_or("S2F50_HCACK", "4"));
+
+        // Replay
+        cfg.replay_file = getenv_or("REPLAY_FILE", "");
+        cfg.replay_format = getenv_or("REPLAY_FORMAT", "auto");
+        cfg.replay_speed = std::stod(getenv_or("REPLAY_SPEED", "0"));
+        cfg.replay_filter_port = std::stoi(getenv_or("REPLAY_FILTER_PORT", "0"));
+
+        // Sinks
+        cfg.sinks = getenv_or("SINKS", "postgres");
+        cfg.arrow_dir = getenv_or("ARROW_DIR", "./data");
+        cfg.arrow_roll_rows = std::stoul(getenv_or("ARROW_ROLL_ROWS", "100000"));
+        cfg.arrow_roll_sec = std::stoul(getenv_or("ARROW_ROLL_SEC", "300"));
+        cfg.shm_ring_name = getenv_or("SHM_RING_NAME", "/secs-ring");
+        cfg.shm_ring_slots = std::stoul(getenv_or("SHM_RING_SLOTS", "65536"));
+        cfg.shm_ring_slot_size = std::stoul(getenv_or("SHM_RING_SLOT_SIZE", "1024"));
+        cfg.shm_ring_mode = static_cast<unsigned>(std::stoul(getenv_or("SHM_RING_MODE", "0600"), nullptr, 8));
+
+        // Routing
+        cfg.route_rules = getenv_or("ROUTE_RULES", "default=parse");
+
+        // S6F11 rollup
+        cfg.rollup_window_sec = std::stoul(getenv_or("ROLLUP_WINDOW_SEC", "0"));
+        cfg.rollup_flush_ms = std::stoul(getenv_or("ROLLUP_FLUSH_MS", "5000"));
+        cfg.rollup_grace_sec = std::stoul(getenv_or("ROLLUP_GRACE_SEC", "10"));
+        cfg.rollup_max_pending = std::stoul(getenv_or("ROLLUP_MAX_PENDING", "1000000"));
+
+        // Carrier state cache
+        cfg.query_socket = getenv_or("QUERY_SOCKET", "");
+        cfg.state_snapshot_path = getenv_or("STATE_SNAPSHOT_PATH", "");
+        cfg.state_snapshot_sec = std::stoul(getenv_or("STATE_SNAPSHOT_SEC", "60"));
+        cfg.state_max_commands = std::stoul(getenv_or("STATE_MAX_COMMANDS", "200000"));
 
         // Performance
         cfg.queue_capacity = std::stoul(getenv_or("QUEUE_CAPACITY", "100000"));
+        cfg.queue_lanes = getenv_or("QUEUE_LANES", "default:*");
+        cfg.exec_mode = getenv_or("EXEC_MODE", "pipeline");
+        cfg.core_count = std::stoul(getenv_or("CORE_COUNT", "0"));
         cfg.worker_count = std::stoul(getenv_or("WORKER_COUNT", "4"));
         cfg.batch_size = std::stoul(getenv_or("BATCH_SIZE", "100"));
         cfg.batch_timeout_ms = std::stoul(getenv_or("BATCH_TIMEOUT_MS", "50"));
 
+        // Control
+        cfg.control_socket = getenv_or("CONTROL_SOCKET", "");
+
+        // Tracing
+        cfg.trace_enabled = getenv_or("TRACE_ENABLED", "0") != "0";
+        cfg.trace_buffer_events = std::stoul(getenv_or("TRACE_BUFFER_EVENTS", "65536"));
+        cfg.trace_dir = getenv_or("TRACE_DIR", ".");
+
         return cfg;
     }
 
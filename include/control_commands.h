@@ -0,0 +1,61 @@
+#pragma once
+
+#include "control_server.h"
+#include "rate_limiter.h"
+#include <spdlog/spdlog.h>
+#include <charconv>
+#include <climits>
+#include <stdexcept>
+#include <string>
+
+namespace secs {
+
+// 제어 명령 숫자 인자 (부호 / 잔여 문자 거부, [min, max] 범위 확인)
+template<typename T>
+T parse_arg(const std::string& s, T min, T max) {
+    T value{};
+    const char* end = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), end, value);
+    if (s.empty() || s[0] == '-' || ec != std::errc() || ptr != end || value < min || value > max) {
+        throw std::invalid_argument(fmt::format("{}~{} 범위의 숫자 필요: {}", min, max, s));
+    }
+    return value;
+}
+
+inline size_t arg_size(const ControlServer::Args& args, size_t min, size_t max) {
+    if (args.empty()) {
+        throw std::invalid_argument("숫자 인자 필요");
+    }
+    return parse_arg<size_t>(args[0], min, max);
+}
+
+// rate_limit                              → 현황 (throttle 상위 장비)
+// rate_limit default <rate> [burst]       → 기본값 변경
+// rate_limit <deviceId> <rate> [burst]    → 장비 override
+// rate_limit <deviceId> clear             → override 제거
+inline void register_rate_limit_command(ControlServer& control, DeviceRateLimiter& limiter) {
+    // rate는 1초 간격(ns)이 0이 되지 않는 범위까지
+    constexpr size_t kMaxRate = 1000000000;
+
+    control.on("rate_limit", [&limiter](const ControlServer::Args& args) {
+        if (args.size() >= 2) {
+            auto device = [&]() { return parse_arg<int>(args[0], 0, INT_MAX); };
+            if (args[1] == "clear") {
+                limiter.clear_device(device());
+            } else {
+                size_t rate = parse_arg<size_t>(args[1], 0, kMaxRate);
+                size_t burst = args.size() > 2 ? parse_arg<size_t>(args[2], 0, kMaxRate) : 0;
+                if (args[0] == "default") {
+                    limiter.set_default(rate, burst);
+                } else {
+                    limiter.set_device(device(), rate, burst);
+                }
+            }
+        } else if (!args.empty()) {
+            throw std::invalid_argument("default|<deviceId> <rate> [burst] | <deviceId> clear");
+        }
+        return limiter.stats();
+    });
+}
+
+} // namespace secs
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <utility>  // boost/asio/awaitable.hpp가 std::exchange를 include 없이 사용
+#include <boost/asio.hpp>
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <sys/stat.h>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+namespace secs {
+
+// 로컬 Unix-domain 명령 서버
+// 한 줄에 명령 하나 ("<command> [args...]\n"), 응답은 JSON 한 줄.
+//   echo "stats" | socat - UNIX-CONNECT:/run/secs-receiver.sock
+class ControlServer {
+public:
+    // 명령 한 줄 최대 길이 (초과 시 연결 종료)
+    static constexpr size_t kMaxLine = 4096;
+
+    using Args = std::vector<std::string>;
+    using Handler = std::function<nlohmann::json(const Args&)>;
+
+    explicit ControlServer(std::string path)
+        : path_(std::move(path))
+        , acceptor_(io_context_)
+    {
+        on("help", [this](const Args&) {
+            nlohmann::json cmds = nlohmann::json::array();
+            for (const auto& [name, _] : handlers_) {
+                cmds.push_back(name);
+            }
+            return nlohmann::json{{"commands", cmds}};
+        });
+    }
+
+    ~ControlServer() {
+        stop();
+    }
+
+    // start() 이전에 등록
+    void on(const std::string& command, Handler handler) {
+        handlers_[command] = std::move(handler);
+    }
+
+    void start() {
+        // 이전 실행이 남긴 소켓 파일 제거
+        std::remove(path_.c_str());
+
+        boost::asio::local::stream_protocol::endpoint ep(path_);
+        acceptor_.open(ep.protocol());
+
+        // 소유자만 접근 (설정 변경 / 상태 조회 권한)
+        // 소켓 파일이 생성 시점부터 0700이 되도록 bind 동안 umask 적용 (bind 후 chmod 사이 노출 방지)
+        boost::system::error_code ec;
+        mode_t old_mask = ::umask(0077);
+        acceptor_.bind(ep, ec);
+        ::umask(old_mask);
+        if (ec) {
+            throw boost::system::system_error(ec, "제어 소켓 bind 실패: " + path_);
+        }
+        if (::chmod(path_.c_str(), 0600) != 0) {
+            spdlog::warn("제어 소켓 권한 설정 실패: {} ({})", path_, std::strerror(errno));
+        }
+        acceptor_.listen();
+
+        do_accept();
+        thread_ = std::thread([this]() { io_context_.run(); });
+
+        spdlog::info("제어 소켓 시작: {}", path_);
+    }
+
+    void stop() {
+        if (!thread_.joinable()) {
+            return;
+        }
+        boost::system::error_code ec;
+        acceptor_.close(ec);
+        io_context_.stop();
+        thread_.join();
+        std::remove(path_.c_str());
+    }
+
+    // 명령 실행 (소켓 외 경로에서도 사용 가능)
+    std::string execute(const std::string& line) const {
+        std::istringstream iss(line);
+        std::string command;
+        iss >> command;
+
+        Args args;
+        for (std::string arg; iss >> arg;) {
+            args.push_back(arg);
+        }
+
+        nlohmann::json resp;
+        auto it = handlers_.find(command);
+        if (it == handlers_.end()) {
+            resp = {{"ok", false}, {"error", "unknown command: " + command}};
+        } else {
+            try {
+                resp = it->second(args);
+                if (!resp.is_object()) {
+                    resp = {{"result", resp}};
+                }
+                resp["ok"] = true;
+            }
+            catch (const std::exception& e) {
+                resp = {{"ok", false}, {"error", e.what()}};
+            }
+        }
+        return resp.dump() + "\n";
+    }
+
+private:
+    class Session : public std::enable_shared_from_this<Session> {
+    public:
+        Session(boost::asio::local::stream_protocol::socket socket, const ControlServer& server)
+            : socket_(std::move(socket))
+            , buffer_(kMaxLine)
+            , server_(server)
+        {}
+
+        void read() {
+            auto self = shared_from_this();
+            boost::asio::async_read_until(socket_, buffer_, '\n',
+                [this, self](const boost::system::error_code& ec, std::size_t) {
+                    if (ec) {
+                        return;  // 클라이언트 종료 또는 kMaxLine 초과
+                    }
+                    std::istream is(&buffer_);
+                    std::string line;
+                    std::getline(is, line);
+                    if (!line.empty() && line.back() == '\r') {
+                        line.pop_back();
+                    }
+                    write(server_.execute(line));
+                });
+        }
+
+    private:
+        void write(std::string resp) {
+            auto self = shared_from_this();
+            auto data = std::make_shared<std::string>(std::move(resp));
+            boost::asio::async_write(socket_, boost::asio::buffer(*data),
+                [this, self, data](const boost::system::error_code& ec, std::size_t) {
+                    if (!ec) {
+                        read();
+                    }
+                });
+        }
+
+        boost::asio::local::stream_protocol::socket socket_;
+        boost::asio::streambuf buffer_;
+        const ControlServer& server_;
+    };
+
+    void do_accept() {
+        acceptor_.async_accept(
+            [this](const boost::system::error_code& ec, boost::asio::local::stream_protocol::socket socket) {
+                if (ec) {
+                    if (ec != boost::asio::error::operation_aborted) {
+                        spdlog::error("제어 소켓 accept 오류: {}", ec.message());
+                    }
+                    return;
+                }
+                std::make_shared<Session>(std::move(socket), *this)->read();
+                do_accept();
+            });
+    }
+
+private:
+    std::string path_;
+    std::map<std::string, Handler> handlers_;
+
+    boost::asio::io_context io_context_;
+    boost::asio::local::stream_protocol::acceptor acceptor_;
+    std::thread thread_;
+};
+
+} // namespace secs
@@ -2,34 +2,44 @@
 
 #include "config.h"
 #include "message.h"
+#include "sink.h"
+#include "retention_policy.h"
+#include "header_peek.h"
+#include "tracer.h"
 #include <pqxx/pqxx>
 #include <spdlog/spdlog.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
 #include <memory>
+#include <optional>
 #include <sstream>
 
 namespace secs {
 
-class DatabaseWriter {
+class DatabaseWriter : public Sink {
 public:
-    explicit DatabaseWriter(const Config& cfg) 
+    explicit DatabaseWriter(const Config& cfg)
+        : DatabaseWriter(cfg, cfg.db_host, cfg.db_port, cfg.db_name)
+    {}
+
+    // 대상 DB 지정 (샤딩: DB_TARGETS의 각 항목)
+    DatabaseWriter(const Config& cfg, const std::string& host, uint16_t port, const std::string& dbname)
         : config_(cfg)
+        , retention_(cfg.raw_retention)
         , total_inserted_(0)
+        , raw_bytes_written_(0)
+        , raw_skipped_(0)
+        , raw_invalid_body_(0)
     {
         // Connection string 생성
-        std::ostringstream oss;
-        oss << "host=" << cfg.db_host
-            << " port=" << cfg.db_port
-            << " dbname=" << cfg.db_name
-            << " user=" << cfg.db_user
-            << " password=" << cfg.db_password;
-        
-        conn_str_ = oss.str();
+        conn_str_ = connection_string(cfg, host, port, dbname);
         
         // Connection 생성
         conn_ = std::make_unique<pqxx::connection>(conn_str_);
         
-        spdlog::info("DB 연결 성공: {}:{}/{}", 
-                     cfg.db_host, cfg.db_port, cfg.db_name);
+        spdlog::info("DB 연결 성공: {}:{}/{}", host, port, dbname);
     }
 
     // 배치 단위 삽입
@@ -39,28 +49,43 @@ public:
         }
         
         try {
+            // 이전 배치에서 연결이 끊겼으면 재연결 (실패 시 이번 배치 실패)
+            if (!conn_ || !conn_->is_open()) {
+                conn_ = std::make_unique<pqxx::connection>(conn_str_);
+                spdlog::info("DB 재연결 성공");
+            }
+
+            TraceScope trace_insert("pg_insert", batch.size());
             pqxx::work txn(*conn_);
             
             for (size_t i = 0; i < batch.size(); ++i) {
                 const auto& raw_msg = batch.raw_messages[i];
                 const auto& parsed = batch.parsed_messages[i];
                 
-                // 1. secs_raw_messages 삽입
-                int raw_id = insert_raw_message(txn, raw_msg, parsed);
+                // 1. secs_raw_messages 삽입 (보관 정책에 따라 생략 가능)
+                std::optional<int> raw_id = insert_raw_message(txn, raw_msg, parsed);
                 
                 // 2. 파싱된 테이블 삽입
                 if (parsed) {
-                    insert_parsed_message(txn, parsed, raw_id);
+                    insert_parsed_message(txn, parsed, raw_id.value_or(0));
                 }
             }
             
-            txn.commit();
+            {
+                TraceScope trace_commit("pg_commit");
+                txn.commit();
+            }
             total_inserted_ += batch.size();
         }
         catch (const pqxx::sql_error& e) {
             spdlog::error("DB 오류: {} - Query: {}", e.what(), e.query());
             throw;
         }
+        catch (const pqxx::broken_connection& e) {
+            spdlog::error("DB 연결 끊김: {}", e.what());
+            conn_.reset();
+            throw;
+        }
         catch (const std::exception& e) {
             spdlog::error("DB 배치 삽입 실패: {}", e.what());
             throw;
@@ -68,58 +93,112 @@ public:
     }
 
     uint64_t total_inserted() const { return total_inserted_; }
+    
+    // Sink 인터페이스
+    const char* name() const override { return "postgres"; }
+    void write_batch(const MessageBatch& batch) override { insert_batch(batch); }
+    uint64_t total_written() const override { return total_inserted_; }
+    uint64_t bytes_written() const override { return raw_bytes_written_; }
+    
+    static std::string connection_string(const Config& cfg) {
+        return connection_string(cfg, cfg.db_host, cfg.db_port, cfg.db_name);
+    }
+
+    static std::string connection_string(const Config& cfg, const std::string& host,
+                                         uint16_t port, const std::string& dbname) {
+        std::ostringstream oss;
+        oss << "host=" << host
+            << " port=" << port
+            << " dbname=" << dbname
+            << " user=" << cfg.db_user
+            << " password=" << cfg.db_password;
+        return oss.str();
+    }
+    
+    // secs_raw_messages에 전송한 바이트 (헤더 + body, 근사치)
+    uint64_t raw_bytes_written() const { return raw_bytes_written_; }
+    uint64_t raw_skipped() const { return raw_skipped_; }
+    uint64_t raw_invalid_body() const { return raw_invalid_body_; }
 
 private:
-    int insert_raw_message(pqxx::work& txn, const RawMessage& raw, 
-                          const std::shared_ptr<ParsedMessage>& parsed) {
+    // secs_raw_messages 삽입 (RAW_RETENTION 정책 적용)
+    // 반환값: raw row id, 보관하지 않은 경우 nullopt
+    std::optional<int> insert_raw_message(pqxx::work& txn, const RawMessage& raw, 
+                                          const std::shared_ptr<ParsedMessage>& parsed) {
         
-        // Raw JSON 파싱하여 timestamp 추출
         std::string timestamp_val;
         int stream_val = 0;
         int function_val = 0;
         bool wbit_val = false;
         int device_id_val = 0;
         std::string system_bytes_val;
-        std::string raw_body_str = "{}";
+        const json* body = nullptr;
+        std::string_view body_text;
         
-        try {
-            std::string raw_json(raw.bytes(), raw.bytes() + raw.size());
-            json msg = json::parse(raw_json);
-            
-            timestamp_val = msg.value("timestamp", "");
-            stream_val = msg.value("stream", 0);
-            function_val = msg.value("function", 0);
-            wbit_val = msg.value("wbit", false);
-            device_id_val = msg.value("deviceId", 0);
-            system_bytes_val = msg.value("systemBytes", "");
-            
-            if (msg.contains("body")) {
-                raw_body_str = msg["body"].dump();
-            }
+        if (parsed) {
+            // 파싱 완료된 메시지는 재파싱 없이 공통 필드 사용
+            timestamp_val = parsed->timestamp;
+            stream_val = parsed->stream;
+            function_val = parsed->function;
+            wbit_val = parsed->wbit;
+            device_id_val = parsed->device_id;
+            system_bytes_val = parsed->system_bytes;
+            body = &parsed->raw_body;
+        }
+        else if (auto hdr = HeaderPeek::peek(raw.bytes(), raw.size())) {
+            // raw 전용 메시지: 헤더 스캔만으로 컬럼 추출, body는 원본 텍스트 그대로 사용
+            timestamp_val = hdr->timestamp;
+            stream_val = hdr->stream;
+            function_val = hdr->function;
+            wbit_val = hdr->wbit;
+            device_id_val = hdr->device_id;
+            system_bytes_val = hdr->system_bytes;
+            body_text = hdr->body;
         }
-        catch (const json::exception& e) {
-            spdlog::warn("Raw JSON 파싱 실패 (timestamp 추출): {}", e.what());
-            // 파싱 실패 시 현재 시간 사용
-            auto now = std::chrono::system_clock::now();
-            auto time_t_now = std::chrono::system_clock::to_time_t(now);
-            std::stringstream ss;
-            ss << std::put_time(std::gmtime(&time_t_now), "%Y-%m-%dT%H:%M:%S");
-            timestamp_val = ss.str() + "Z";
+        else {
+            spdlog::warn("Raw JSON 헤더 추출 실패 ({}B)", raw.size());
+        }
+        
+        RawRetention mode = retention_.decide(stream_val, function_val);
+        if (mode == RawRetention::None) {
+            raw_skipped_++;
+            return std::nullopt;
         }
         
         // timestamp가 비어있으면 현재 시간 사용
         if (timestamp_val.empty()) {
-            auto now = std::chrono::system_clock::now();
-            auto time_t_now = std::chrono::system_clock::to_time_t(now);
-            std::stringstream ss;
-            ss << std::put_time(std::gmtime(&time_t_now), "%Y-%m-%dT%H:%M:%S");
-            timestamp_val = ss.str() + "Z";
+            timestamp_val = now_timestamp();
+        }
+        
+        // raw_body: Full이면 JSONB 또는 zlib 압축(BYTEA), Header면 둘 다 NULL
+        std::string raw_body_str;
+        std::basic_string<std::byte> raw_body_z;  // libpqxx 7: bytea 파라미터
+        if (mode == RawRetention::Full) {
+            if (body) {
+                raw_body_str = body->dump();
+            } else if (body_text.empty()) {
+                raw_body_str = "{}";
+            } else if (json::accept(body_text.begin(), body_text.end())) {
+                raw_body_str = std::string(body_text);
+            } else {
+                // HeaderPeek은 괄호 균형만 보므로 깨진 body가 올 수 있다.
+                // ::jsonb 캐스트 실패는 배치 트랜잭션 전체를 중단시키므로 헤더만 남긴다.
+                if (raw_invalid_body_++ % 1000 == 0) {
+                    spdlog::warn("raw body JSON 오류 - 헤더만 저장 (장비 {}, S{}F{}, 누적 {}건)",
+                                 device_id_val, stream_val, function_val, raw_invalid_body_);
+                }
+            }
+            if (config_.raw_compress_level > 0 && !raw_body_str.empty() &&
+                raw_body_str.size() >= config_.raw_compress_min_bytes) {
+                raw_body_z = compress(raw_body_str);
+                raw_body_str.clear();
+            }
         }
         
         std::string query = 
             "INSERT INTO secs_raw_messages "
-            "(timestamp, stream, function, wbit, device_id, system_bytes, ptype, stype, raw_body) "
-            "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9::jsonb) "
+            "(timestamp, stream, function, wbit, device_id, system_bytes, ptype, stype, raw_body, raw_body_z) "
+            "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, NULLIF($9, '')::jsonb, NULLIF($10, ''::bytea)) "
             "RETURNING id";
         
         pqxx::result r = txn.exec_params(
@@ -132,16 +211,45 @@ private:
             system_bytes_val,
             0,  // ptype
             0,  // stype
-            raw_body_str
+            raw_body_str,
+            raw_body_z
         );
         
+        raw_bytes_written_ += kRawHeaderBytes + timestamp_val.size() + system_bytes_val.size()
+                            + raw_body_str.size() + raw_body_z.size();
+        
         return r[0][0].as<int>();
     }
 
+    std::basic_string<std::byte> compress(const std::string& input) const {
+        uLongf out_len = compressBound(input.size());
+        std::basic_string<std::byte> out(out_len, std::byte{0});
+        int rc = compress2(reinterpret_cast<Bytef*>(out.data()), &out_len,
+                           reinterpret_cast<const Bytef*>(input.data()), input.size(),
+                           static_cast<int>(config_.raw_compress_level));
+        if (rc != Z_OK) {
+            throw std::runtime_error("raw_body 압축 실패 (zlib " + std::to_string(rc) + ")");
+        }
+        out.resize(out_len);
+        return out;
+    }
+
+    static std::string now_timestamp() {
+        auto now = std::chrono::system_clock::now();
+        auto time_t_now = std::chrono::system_clock::to_time_t(now);
+        std::stringstream ss;
+        ss << std::put_time(std::gmtime(&time_t_now), "%Y-%m-%dT%H:%M:%S");
+        return ss.str() + "Z";
+    }
+
+    // raw_id가 없으면 (RAW_RETENTION=none) raw_message_id는 NULL
     void insert_parsed_message(pqxx::work& txn, const std::shared_ptr<ParsedMessage>& parsed, int raw_id) {
         if (auto s2f49 = std::dynamic_pointer_cast<S2F49Message>(parsed)) {
             insert_s2f49(txn, s2f49, raw_id);
         }
+        else if (auto s6f11 = std::dynamic_pointer_cast<S6F11Message>(parsed)) {
+            insert_s6f11(txn, s6f11, raw_id);
+        }
         // 다른 메시지 타입들...
     }
 
@@ -151,7 +259,7 @@ private:
             "(raw_message_id, timestamp, device_id, system_bytes, "
             " txn_code, txn_id, command_type, command_id, priority, "
             " carrier_id, source, dest, source_type, dest_type) "
-            "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14)";
+            "VALUES (NULLIF($1, 0), $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14)";
         
         txn.exec_params(
             query,
@@ -177,7 +285,7 @@ private:
             "INSERT INTO s6f11_event_reports "
             "(raw_message_id, timestamp, device_id, system_bytes, "
             " event_report_id, event_id, data_items) "
-            "VALUES ($1, $2, $3, $4, $5, $6, $7::jsonb)";
+            "VALUES (NULLIF($1, 0), $2, $3, $4, $5, $6, $7::jsonb)";
         
         txn.exec_params(
             query,
@@ -192,10 +300,17 @@ private:
     }
 
 private:
+    // 고정 길이 헤더 컬럼 (stream, function, wbit, device_id, ptype, stype) 근사 크기
+    static constexpr size_t kRawHeaderBytes = 24;
+
     const Config& config_;
+    RetentionPolicy retention_;
     std::string conn_str_;
     std::unique_ptr<pqxx::connection> conn_;
     uint64_t total_inserted_;
+    uint64_t raw_bytes_written_;
+    uint64_t raw_skipped_;
+    uint64_t raw_invalid_body_;
 };
 
 } // namespace secs
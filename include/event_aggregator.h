@@ -0,0 +1,386 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "db_writer.h"
+#include <pqxx/pqxx>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <ctime>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace secs {
+
+// S6F11 이벤트 윈도우 집계 (tumbling window)
+//
+// (window, device, event_id, item)별 누산기를 샤드된 해시맵에 유지하고,
+// 닫힌 윈도우를 주기적으로 s6f11_event_rollups에 bulk upsert 한다.
+//   item_name = ''     : 이벤트 건수 (event_count)
+//   item_name = 'TEMP' : 숫자형 data item의 count / min / max / sum (이름 없는 item은 제외)
+// 늦게 도착한 이벤트는 ON CONFLICT로 기존 rollup row에 병합된다.
+// DB 장애 중 flush 실패분은 ROLLUP_MAX_PENDING row까지만 보류하고 초과분(오래된 것)은 버린다.
+// 보류분과 새로 닫힌 윈도우의 같은 키 row는 기록 전에 하나로 병합한다
+// (한 INSERT에 같은 키가 두 번 오면 ON CONFLICT DO UPDATE가 문 전체를 거부).
+class EventAggregator {
+public:
+    struct RollupRow {
+        int64_t window_start;  // epoch seconds
+        int device_id;
+        int event_id;
+        std::string item_name;
+        uint64_t event_count;
+        uint64_t value_count;
+        double value_min;
+        double value_max;
+        double value_sum;
+    };
+
+    // rollup row 기록 함수 (실패 시 예외)
+    using RowWriter = std::function<void(const std::vector<RollupRow>&)>;
+
+    explicit EventAggregator(const Config& cfg)
+        : config_(cfg)
+        , window_sec_(static_cast<int64_t>(cfg.rollup_window_sec))
+        , running_(false)
+        , total_events_(0)
+        , total_flushed_rows_(0)
+        , total_dropped_rows_(0)
+    {}
+
+    ~EventAggregator() {
+        stop();
+    }
+
+    // start() 이전에 호출 (기본: s6f11_event_rollups upsert)
+    void set_writer(RowWriter writer) {
+        writer_ = std::move(writer);
+    }
+
+    void start() {
+        running_ = true;
+        flush_thread_ = std::thread([this]() { flush_main(); });
+        spdlog::info("S6F11 집계 시작: window={}s, flush={}ms",
+                     config_.rollup_window_sec, config_.rollup_flush_ms);
+    }
+
+    // 열린 윈도우까지 모두 flush 후 종료
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex_);
+            if (!running_) {
+                return;
+            }
+            running_ = false;
+        }
+        flush_cv_.notify_all();
+        if (flush_thread_.joinable()) {
+            flush_thread_.join();
+        }
+    }
+
+    // 워커 스레드에서 호출
+    void add(const S6F11Message& msg) {
+        int64_t window = window_of(msg.timestamp);
+        Shard& shard = shards_[shard_of(msg.device_id, msg.event_id)];
+
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // 이벤트 건수
+        shard.accs[Key{window, msg.device_id, msg.event_id, {}}].event_count++;
+
+        // 숫자형 data item 통계
+        if (msg.data_items.is_array()) {
+            for (const auto& item : msg.data_items) {
+                auto value = item.find("value");
+                if (value == item.end() || !value->is_number()) {
+                    continue;
+                }
+                // 빈 이름은 이벤트 건수 row (item_name = '')와 키가 겹치므로 집계하지 않는다
+                auto name = item.find("name");
+                if (name == item.end() || !name->is_string() || name->get_ref<const std::string&>().empty()) {
+                    continue;
+                }
+                double v = value->get<double>();
+                if (!std::isfinite(v)) {
+                    continue;
+                }
+                Acc& acc = shard.accs[Key{window, msg.device_id, msg.event_id,
+                                          name->get<std::string>()}];
+                acc.event_count++;
+                if (acc.value_count == 0 || v < acc.value_min) acc.value_min = v;
+                if (acc.value_count == 0 || v > acc.value_max) acc.value_max = v;
+                acc.value_sum += v;
+                acc.value_count++;
+            }
+        }
+
+        total_events_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    nlohmann::json stats() const {
+        size_t open = 0;
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            open += shard.accs.size();
+        }
+        size_t pending;
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex_);
+            pending = pending_.size();
+        }
+        return {
+            {"window_sec", window_sec_},
+            {"events", total_events_.load()},
+            {"open_accumulators", open},
+            {"pending_rows", pending},
+            {"flushed_rows", total_flushed_rows_.load()},
+            {"dropped_rows", total_dropped_rows_.load()}
+        };
+    }
+
+private:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kRowsPerStatement = 1000;
+
+    struct Key {
+        int64_t window_start;
+        int device_id;
+        int event_id;
+        std::string item_name;
+
+        bool operator==(const Key& o) const {
+            return window_start == o.window_start && device_id == o.device_id &&
+                   event_id == o.event_id && item_name == o.item_name;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            size_t h = std::hash<int64_t>()(k.window_start);
+            h = h * 31 + std::hash<int>()(k.device_id);
+            h = h * 31 + std::hash<int>()(k.event_id);
+            h = h * 31 + std::hash<std::string>()(k.item_name);
+            return h;
+        }
+    };
+
+    struct Acc {
+        uint64_t event_count = 0;
+        uint64_t value_count = 0;
+        double value_min = 0.0;
+        double value_max = 0.0;
+        double value_sum = 0.0;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, Acc, KeyHash> accs;
+    };
+
+    static size_t shard_of(int device_id, int event_id) {
+        uint64_t h = (static_cast<uint64_t>(static_cast<uint32_t>(device_id)) << 32)
+                   | static_cast<uint32_t>(event_id);
+        h *= 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 60) & (kShards - 1);
+    }
+
+    // "YYYY-MM-DDTHH:MM:SS..." → 윈도우 시작 (epoch seconds), 파싱 실패 시 현재 시각
+    int64_t window_of(const std::string& timestamp) const {
+        std::tm tm{};
+        int64_t epoch;
+        if (std::sscanf(timestamp.c_str(), "%d-%d-%dT%d:%d:%d",
+                        &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                        &tm.tm_hour, &tm.tm_min, &tm.tm_sec) == 6) {
+            tm.tm_year -= 1900;
+            tm.tm_mon -= 1;
+            epoch = static_cast<int64_t>(timegm(&tm));
+        } else {
+            epoch = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+        return epoch - (epoch % window_sec_);
+    }
+
+    // 닫힌 윈도우 (또는 force 시 전체) 누산기를 row로 추출
+    void collect(bool force, std::vector<RollupRow>& out) {
+        int64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        int64_t closed_before = now - window_sec_ - static_cast<int64_t>(config_.rollup_grace_sec);
+
+        for (auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.accs.begin(); it != shard.accs.end();) {
+                if (force || it->first.window_start <= closed_before) {
+                    const Key& k = it->first;
+                    const Acc& a = it->second;
+                    out.push_back(RollupRow{k.window_start, k.device_id, k.event_id, k.item_name,
+                                            a.event_count, a.value_count,
+                                            a.value_min, a.value_max, a.value_sum});
+                    it = shard.accs.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+
+    void flush_main() {
+        std::unique_ptr<pqxx::connection> conn;
+
+        while (true) {
+            bool stopping;
+            {
+                std::unique_lock<std::mutex> lock(flush_mutex_);
+                flush_cv_.wait_for(lock, std::chrono::milliseconds(config_.rollup_flush_ms),
+                                   [this] { return !running_; });
+                stopping = !running_;
+            }
+
+            std::vector<RollupRow> rows;
+            {
+                std::lock_guard<std::mutex> lock(flush_mutex_);
+                rows.swap(pending_);
+            }
+            collect(stopping, rows);
+            merge_rows(rows);
+
+            if (!rows.empty()) {
+                try {
+                    if (writer_) {
+                        writer_(rows);
+                    } else {
+                        if (!conn) {
+                            conn = std::make_unique<pqxx::connection>(
+                                DatabaseWriter::connection_string(config_));
+                        }
+                        write_rows(*conn, rows);
+                    }
+                    total_flushed_rows_ += rows.size();
+                    spdlog::debug("S6F11 rollup {}건 flush", rows.size());
+                }
+                catch (const std::exception& e) {
+                    // 다음 주기에 재시도
+                    spdlog::error("S6F11 rollup flush 실패 ({}건 보류): {}", rows.size(), e.what());
+                    conn.reset();
+                    requeue(rows);
+                }
+            }
+
+            if (stopping) {
+                break;
+            }
+        }
+    }
+
+    // 같은 키 row 병합 (보류분 + 늦게 도착한 같은 윈도우 이벤트)
+    static void merge_rows(std::vector<RollupRow>& rows) {
+        std::unordered_map<Key, size_t, KeyHash> index;
+        std::vector<RollupRow> merged;
+        merged.reserve(rows.size());
+
+        for (auto& r : rows) {
+            auto [it, inserted] = index.try_emplace(
+                Key{r.window_start, r.device_id, r.event_id, r.item_name}, merged.size());
+            if (inserted) {
+                merged.push_back(std::move(r));
+                continue;
+            }
+            RollupRow& m = merged[it->second];
+            if (r.value_count > 0) {
+                m.value_min = m.value_count > 0 ? std::min(m.value_min, r.value_min) : r.value_min;
+                m.value_max = m.value_count > 0 ? std::max(m.value_max, r.value_max) : r.value_max;
+            }
+            m.event_count += r.event_count;
+            m.value_count += r.value_count;
+            m.value_sum += r.value_sum;
+        }
+        rows.swap(merged);
+    }
+
+    // 보류 row는 상한까지만 유지 (오래된 것부터 버림)
+    void requeue(const std::vector<RollupRow>& rows) {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        pending_.insert(pending_.end(), rows.begin(), rows.end());
+
+        size_t limit = config_.rollup_max_pending;
+        if (pending_.size() > limit) {
+            size_t excess = pending_.size() - limit;
+            pending_.erase(pending_.begin(), pending_.begin() + static_cast<ptrdiff_t>(excess));
+            total_dropped_rows_ += excess;
+            spdlog::warn("S6F11 rollup 보류 상한 초과 - {}건 드롭 (누적 {}건)",
+                         excess, total_dropped_rows_.load());
+        }
+    }
+
+    void write_rows(pqxx::connection& conn, const std::vector<RollupRow>& rows) {
+        pqxx::work txn(conn);
+
+        for (size_t begin = 0; begin < rows.size(); begin += kRowsPerStatement) {
+            size_t end = std::min(rows.size(), begin + kRowsPerStatement);
+
+            std::ostringstream sql;
+            sql.precision(17);
+            sql << "INSERT INTO s6f11_event_rollups "
+                   "(window_start, window_sec, device_id, event_id, item_name, "
+                   " event_count, value_count, value_min, value_max, value_sum) VALUES ";
+
+            for (size_t i = begin; i < end; ++i) {
+                const RollupRow& r = rows[i];
+                if (i > begin) {
+                    sql << ',';
+                }
+                sql << "(to_timestamp(" << r.window_start << ")," << window_sec_ << ','
+                    << r.device_id << ',' << r.event_id << ',' << txn.quote(r.item_name) << ','
+                    << r.event_count << ',' << r.value_count << ',';
+                if (r.value_count > 0) {
+                    sql << r.value_min << ',' << r.value_max << ',' << r.value_sum;
+                } else {
+                    sql << "NULL,NULL,NULL";
+                }
+                sql << ')';
+            }
+
+            sql << " ON CONFLICT (window_start, device_id, event_id, item_name) DO UPDATE SET "
+                   "event_count = s6f11_event_rollups.event_count + EXCLUDED.event_count, "
+                   "value_count = s6f11_event_rollups.value_count + EXCLUDED.value_count, "
+                   "value_min = LEAST(s6f11_event_rollups.value_min, EXCLUDED.value_min), "
+                   "value_max = GREATEST(s6f11_event_rollups.value_max, EXCLUDED.value_max), "
+                   "value_sum = COALESCE(s6f11_event_rollups.value_sum, 0) + COALESCE(EXCLUDED.value_sum, 0)";
+
+            txn.exec(sql.str());
+        }
+
+        txn.commit();
+    }
+
+private:
+    const Config& config_;
+    const int64_t window_sec_;
+
+    std::array<Shard, kShards> shards_;
+    RowWriter writer_;
+
+    mutable std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    std::vector<RollupRow> pending_;  // flush 실패분 (재시도 대기)
+    bool running_;
+    std::thread flush_thread_;
+
+    std::atomic<uint64_t> total_events_;
+    std::atomic<uint64_t> total_flushed_rows_;
+    std::atomic<uint64_t> total_dropped_rows_;
+};
+
+} // namespace secs
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace secs {
+
+// 메시지 헤더 (원본 버퍼를 가리키는 view, 복사 없음)
+struct MessageHeader {
+    int stream = 0;
+    int function = 0;
+    int device_id = 0;
+    bool wbit = false;
+    std::string_view timestamp;
+    std::string_view system_bytes;
+    std::string_view body;  // body 값의 원본 JSON 텍스트 (없으면 empty)
+};
+
+// 헤더 전용 고속 스캔
+// 최상위 객체의 키만 훑고 body 등 중첩 값은 구조만 건너뛴다 (DOM 생성/할당 없음).
+// JSON 형식이 깨진 경우 nullopt → 호출 측에서 전체 파싱 경로로 보내 오류를 기록한다.
+class HeaderPeek {
+public:
+    static std::optional<MessageHeader> peek(const uint8_t* data, size_t len) {
+        const char* p = reinterpret_cast<const char*>(data);
+        const char* end = p + len;
+        MessageHeader hdr;
+
+        skip_ws(p, end);
+        if (p == end || *p != '{') {
+            return std::nullopt;
+        }
+        ++p;
+
+        while (true) {
+            skip_ws(p, end);
+            if (p == end) {
+                return std::nullopt;
+            }
+            if (*p == '}') {
+                break;
+            }
+
+            std::string_view key;
+            if (!read_string(p, end, key)) {
+                return std::nullopt;
+            }
+            skip_ws(p, end);
+            if (p == end || *p != ':') {
+                return std::nullopt;
+            }
+            ++p;
+            skip_ws(p, end);
+
+            const char* value_begin = p;
+            if (!skip_value(p, end)) {
+                return std::nullopt;
+            }
+            std::string_view value(value_begin, p - value_begin);
+
+            if (key == "stream") {
+                to_int(value, hdr.stream);
+            } else if (key == "function") {
+                to_int(value, hdr.function);
+            } else if (key == "deviceId") {
+                to_int(value, hdr.device_id);
+            } else if (key == "wbit") {
+                hdr.wbit = (value == "true");
+            } else if (key == "timestamp") {
+                hdr.timestamp = unquote(value);
+            } else if (key == "systemBytes") {
+                hdr.system_bytes = unquote(value);
+            } else if (key == "body") {
+                hdr.body = value;
+            }
+
+            skip_ws(p, end);
+            if (p == end) {
+                return std::nullopt;
+            }
+            if (*p == ',') {
+                ++p;
+                continue;
+            }
+            if (*p == '}') {
+                break;
+            }
+            return std::nullopt;
+        }
+
+        return hdr;
+    }
+
+private:
+    static void skip_ws(const char*& p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+            ++p;
+        }
+    }
+
+    // "..." 문자열 (이스케이프는 건너뛰기만 함), out은 따옴표 제외 내용
+    static bool read_string(const char*& p, const char* end, std::string_view& out) {
+        if (p == end || *p != '"') {
+            return false;
+        }
+        const char* begin = ++p;
+        while (p < end) {
+            if (*p == '\\') {
+                p += 2;
+                continue;
+            }
+            if (*p == '"') {
+                out = std::string_view(begin, p - begin);
+                ++p;
+                return true;
+            }
+            ++p;
+        }
+        return false;
+    }
+
+    static bool skip_value(const char*& p, const char* end) {
+        if (p == end) {
+            return false;
+        }
+        if (*p == '"') {
+            std::string_view ignored;
+            return read_string(p, end, ignored);
+        }
+        if (*p == '{' || *p == '[') {
+            int depth = 0;
+            while (p < end) {
+                char c = *p;
+                if (c == '"') {
+                    std::string_view ignored;
+                    if (!read_string(p, end, ignored)) {
+                        return false;
+                    }
+                    continue;
+                }
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if (c == '}' || c == ']') {
+                    if (--depth == 0) {
+                        ++p;
+                        return true;
+                    }
+                }
+                ++p;
+            }
+            return false;
+        }
+        // 숫자 / true / false / null
+        const char* begin = p;
+        while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+               *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') {
+            ++p;
+        }
+        return p > begin;
+    }
+
+    static void to_int(std::string_view value, int& out) {
+        std::from_chars(value.data(), value.data() + value.size(), out);
+    }
+
+    static std::string_view unquote(std::string_view value) {
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            return value.substr(1, value.size() - 2);
+        }
+        return {};
+    }
+};
+
+} // namespace secs
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "lane_queue.h"
+#include "header_peek.h"
+#include "sequence_tracker.h"
+#include "rate_limiter.h"
+#include "ack_sender.h"
+#include "tracer.h"
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+
+namespace secs {
+
+// 수신 엔진 공통 입구 (수신 스레드에서 데이터그램마다 호출)
+// - 헤더 peek → systemBytes 시퀀스 추적 / 장비별 수신 제한 / 우선순위 lane 분류
+// - 수신 시각 / 송신 주소 기록, 큐 투입 및 큐 오버플로우 집계
+// - 수신 소켓을 S2F50 응답 송신기에 등록 (응답은 파싱 이후 단계에서 송신)
+// per-core 모드는 큐 없이 생성하고 admit()으로 받은 메시지를 스레드 전용 파이프라인에 넣는다.
+// 여러 수신 스레드가 공유해도 안전하다 (tracker 샤딩, limiter lock-free).
+class Ingress {
+public:
+    Ingress(const Config& cfg, LaneQueue* queue)
+        : queue_(queue)
+        , limiter_(cfg.rate_limit_per_sec, cfg.rate_limit_burst,
+                   cfg.rate_limit_overrides, cfg.rate_limit_table_size)
+        , acks_(cfg)
+        , total_queue_drops_(0)
+    {
+        if (cfg.seq_tracking) {
+            tracker_ = std::make_unique<SequenceTracker>(cfg.system_bytes_base);
+        }
+    }
+
+    // 수신 엔진 start()에서 호출 (S2F50 응답을 같은 소켓으로 송신)
+    void attach_socket(int fd) {
+        acks_.attach(fd);
+    }
+
+    // 시퀀스 추적 + 장비별 수신 제한 (nullopt = throttle)
+    std::optional<RawMessage> admit(const uint8_t* data, size_t len, const sockaddr_in* source = nullptr) {
+        std::optional<MessageHeader> hdr;
+        return admit(data, len, source, hdr);
+    }
+
+    // UDP 수신: 장비 제한 초과 또는 큐가 가득 차면 드롭
+    void deliver(const uint8_t* data, size_t len, const sockaddr_in* source = nullptr) {
+        std::optional<MessageHeader> hdr;
+        auto msg = admit(data, len, source, hdr);
+        if (!msg) {
+            return;
+        }
+
+        uint8_t lane = msg->lane;
+        if (!queue_->try_push(std::move(*msg))) {
+            total_queue_drops_.fetch_add(1, std::memory_order_relaxed);
+            if (tracker_ && hdr) {
+                tracker_->on_queue_drop(hdr->device_id);
+            }
+            spdlog::warn("큐 오버플로우 - 메시지 드롭 (lane={}, qsize={})",
+                         queue_->lane_spec(lane).name, queue_->size());
+        }
+    }
+
+    // 캡처 재생: 큐에 여유가 생길 때까지 대기 (false = 큐 닫힘)
+    bool deliver_blocking(const uint8_t* data, size_t len) {
+        // 재생은 backfill이므로 수신 제한을 적용하지 않는다
+        auto hdr = observe(data, len);
+        return queue_->push(make_message(data, len, nullptr, hdr, Tracer::now_ns()));
+    }
+
+    // SO_RXQ_OVFL 누적값 반영 (소켓별 마지막 값은 호출측이 보관)
+    void on_kernel_drop_counter(uint32_t counter, uint32_t& last) {
+        if (counter != last) {
+            if (tracker_) {
+                tracker_->add_kernel_drops(static_cast<uint32_t>(counter - last));
+            }
+            last = counter;
+        }
+    }
+
+    // 커널 드롭 카운터 활성화 (recvmsg cmsg로 누적 드롭 수 전달)
+    static void enable_kernel_drop_counter(int fd) {
+        int one = 1;
+        if (::setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one)) != 0) {
+            spdlog::warn("SO_RXQ_OVFL 설정 실패 - 커널 드롭 집계 불가: {}", std::strerror(errno));
+        }
+    }
+
+    // cmsg에서 SO_RXQ_OVFL 값 추출 (없으면 nullopt)
+    static std::optional<uint32_t> kernel_drop_counter(const cmsghdr* cmsg) {
+        if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+            uint32_t counter;
+            std::memcpy(&counter, CMSG_DATA(cmsg), sizeof(counter));
+            return counter;
+        }
+        return std::nullopt;
+    }
+
+    // recvmsg control 버퍼 크기
+    static constexpr size_t kControlLen = CMSG_SPACE(sizeof(uint32_t));
+
+    const SequenceTracker* tracker() const { return tracker_.get(); }
+    DeviceRateLimiter& limiter() { return limiter_; }
+    AckSender& acks() { return acks_; }
+    uint64_t total_queue_drops() const { return total_queue_drops_.load(); }
+
+    // 손실 리포트 (시퀀스 추적 비활성 시 큐 드롭만)
+    json loss_report() const {
+        json report = tracker_ ? tracker_->report()
+                               : json{{"loss", {{"queue_full", total_queue_drops()}}},
+                                      {"sequence_tracking", false}};
+        report["loss"]["rate_limited"] = limiter_.total_throttled();
+        return report;
+    }
+
+private:
+    std::optional<RawMessage> admit(const uint8_t* data, size_t len, const sockaddr_in* source,
+                                    std::optional<MessageHeader>& hdr) {
+        hdr = observe(data, len);
+        uint64_t now = Tracer::now_ns();
+
+        // 폭주 장비만 잘라내어 공유 큐 / 코어를 보호
+        if (hdr && limiter_.enabled() && !limiter_.allow(hdr->device_id, now)) {
+            return std::nullopt;
+        }
+        return make_message(data, len, source, hdr, now);
+    }
+
+    // 수신 시각 (lane 지연 / 큐 대기 추적) + lane 분류
+    RawMessage make_message(const uint8_t* data, size_t len, const sockaddr_in* source,
+                            const std::optional<MessageHeader>& hdr, uint64_t now) const {
+        RawMessage msg(data, len);
+        msg.recv_ns = now;
+        if (source) {
+            msg.source = *source;
+        }
+        msg.lane = queue_ ? queue_->classify(hdr) : 0;
+        return msg;
+    }
+
+    // 헤더가 필요한 기능이 모두 꺼져 있으면 읽지 않는다
+    std::optional<MessageHeader> observe(const uint8_t* data, size_t len) {
+        if (!tracker_ && (!queue_ || queue_->lane_count() == 1) && !limiter_.enabled()) {
+            return std::nullopt;
+        }
+        auto hdr = HeaderPeek::peek(data, len);
+        if (hdr && tracker_) {
+            tracker_->on_received(*hdr);
+        }
+        return hdr;
+    }
+
+private:
+    LaneQueue* queue_;  // per-core 모드에서는 nullptr
+    std::unique_ptr<SequenceTracker> tracker_;
+    DeviceRateLimiter limiter_;
+    AckSender acks_;
+    std::atomic<uint64_t> total_queue_drops_;
+};
+
+} // namespace secs
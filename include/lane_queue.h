@@ -0,0 +1,334 @@
+#pragma once
+
+#include "message.h"
+#include "header_peek.h"
+#include "latency_histogram.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// 우선순위 lane 큐
+//
+// (stream, function) 클래스별로 lane을 나누어 이벤트 폭주가 반송 명령을 막지 않도록 한다.
+//   QUEUE_LANES = "name:classes:capacity:weight[:batch_timeout_ms];..."
+//   예) "high:2/49 2/41:20000:8:5;default:*:100000:1"
+// - classes: 공백 구분 "S/F" (* = 전체), 앞에 선언된 lane이 우선
+// - capacity: lane별 용량 (가득 차면 해당 lane만 드롭)
+// - weight: smooth weighted round-robin 비중 (낮은 lane도 굶지 않음)
+// - batch_timeout_ms: 이 lane 메시지가 배치에 들어오면 배치 마감을 앞당김 (0 = 공통 설정)
+// 클래스에 해당하지 않는 메시지는 마지막 lane으로 간다.
+class LaneQueue {
+public:
+    struct LaneSpec {
+        std::string name;
+        std::vector<std::pair<int, int>> classes;  // -1 = wildcard
+        size_t capacity = 0;
+        int weight = 1;
+        size_t batch_timeout_ms = 0;
+    };
+
+    // default_capacity: 용량 미지정 lane에 적용 (QUEUE_CAPACITY)
+    LaneQueue(const std::string& spec, size_t default_capacity)
+        : closed_(false)
+    {
+        for (auto& ls : parse(spec, default_capacity)) {
+            auto lane = std::make_unique<Lane>();
+            lane->spec = std::move(ls);
+            lanes_.push_back(std::move(lane));
+        }
+        if (lanes_.empty()) {
+            throw std::invalid_argument("QUEUE_LANES: lane이 없음");
+        }
+        if (lanes_.size() > 255) {
+            throw std::invalid_argument("QUEUE_LANES: lane은 255개 이하");
+        }
+
+        // (stream, function) → lane 직접 조회 테이블 (먼저 선언된 lane 우선)
+        uint8_t fallback = static_cast<uint8_t>(lanes_.size() - 1);
+        class_lane_.fill(kUnassigned);
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            for (auto [s, f] : lanes_[i]->spec.classes) {
+                for (int st = 0; st < kStreams; ++st) {
+                    for (int fn = 0; fn < kFunctions; ++fn) {
+                        if ((s < 0 || s == st) && (f < 0 || f == fn)) {
+                            uint8_t& slot = class_lane_[st * kFunctions + fn];
+                            if (slot == kUnassigned) {
+                                slot = static_cast<uint8_t>(i);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        for (auto& slot : class_lane_) {
+            if (slot == kUnassigned) {
+                slot = fallback;
+            }
+        }
+    }
+
+    size_t lane_count() const { return lanes_.size(); }
+    const LaneSpec& lane_spec(size_t lane) const { return lanes_[lane]->spec; }
+
+    // 헤더 peek 결과로 lane 결정 (헤더 없음 → 마지막 lane)
+    uint8_t classify(const std::optional<MessageHeader>& hdr) const {
+        if (hdr && hdr->stream >= 0 && hdr->stream < kStreams &&
+            hdr->function >= 0 && hdr->function < kFunctions) {
+            return class_lane_[hdr->stream * kFunctions + hdr->function];
+        }
+        return static_cast<uint8_t>(lanes_.size() - 1);
+    }
+
+    // 블로킹 push (해당 lane에 여유가 생길 때까지 대기)
+    bool push(RawMessage&& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Lane& lane = *lanes_[item.lane];
+
+        lane.blocked_producers++;
+        lane.not_full.wait(lock, [&] {
+            return lane.items.size() < lane.spec.capacity || closed_;
+        });
+        lane.blocked_producers--;
+
+        if (closed_) {
+            return false;
+        }
+
+        lane.items.push_back(std::move(item));
+        lane.pushed++;
+        size_++;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // 논블로킹 push (lane이 가득 차면 false, lane 드롭 집계)
+    bool try_push(RawMessage&& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Lane& lane = *lanes_[item.lane];
+
+        if (lane.items.size() >= lane.spec.capacity || closed_) {
+            lane.dropped++;
+            return false;
+        }
+
+        lane.items.push_back(std::move(item));
+        lane.pushed++;
+        size_++;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // weighted round-robin으로 비어있지 않은 lane에서 꺼내기 (타임아웃)
+    std::optional<RawMessage> pop(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (!not_empty_.wait_for(lock, timeout, [this] {
+            return size_ > 0 || closed_;
+        })) {
+            return std::nullopt;  // 타임아웃
+        }
+
+        if (size_ == 0) {
+            return std::nullopt;  // 닫힘
+        }
+
+        Lane& lane = *lanes_[select_lane()];
+        RawMessage item = std::move(lane.items.front());
+        lane.items.pop_front();
+        size_--;
+        // 대기 중인 생산자가 있을 때만 (= lane이 가득 찼을 때) 빈 자리 하나당 하나만 깨운다
+        if (lane.blocked_producers > 0) {
+            lane.not_full.notify_one();
+        }
+        return item;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    // 전체 용량 (lane 합계)
+    size_t capacity() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t total = 0;
+        for (const auto& lane : lanes_) {
+            total += lane->spec.capacity;
+        }
+        return total;
+    }
+
+    // 런타임 용량 변경 (줄여도 이미 들어있는 아이템은 유지)
+    void set_capacity(size_t lane, size_t capacity) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lanes_.at(lane)->spec.capacity = capacity;
+        lanes_.at(lane)->not_full.notify_all();
+    }
+
+    // 이름으로 lane 찾기 (없으면 nullopt)
+    std::optional<size_t> find_lane(const std::string& name) const {
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            if (lanes_[i]->spec.name == name) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // 배치 마감 단축 (0 = 공통 설정 사용)
+    size_t batch_timeout_ms(size_t lane) const {
+        return lanes_[lane]->spec.batch_timeout_ms;
+    }
+
+    // 수신 → sink 기록 완료 지연 (WorkerPool에서 배치 기록 후 호출)
+    void record_latency(size_t lane, uint64_t ns) {
+        lanes_[lane]->latency.record(ns);
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        for (auto& lane : lanes_) {
+            lane->not_full.notify_all();
+        }
+    }
+
+    uint64_t total_dropped() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t n = 0;
+        for (const auto& lane : lanes_) {
+            n += lane->dropped;
+        }
+        return n;
+    }
+
+    json stats() const {
+        json lanes = json::array();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& lane : lanes_) {
+            lanes.push_back({
+                {"name", lane->spec.name},
+                {"depth", lane->items.size()},
+                {"capacity", lane->spec.capacity},
+                {"weight", lane->spec.weight},
+                {"batch_timeout_ms", lane->spec.batch_timeout_ms},
+                {"pushed", lane->pushed},
+                {"dropped", lane->dropped},
+                {"latency", lane->latency.stats()}
+            });
+        }
+        return lanes;
+    }
+
+private:
+    static constexpr int kStreams = 128;
+    static constexpr int kFunctions = 256;
+    static constexpr uint8_t kUnassigned = 0xFF;
+
+    struct Lane {
+        LaneSpec spec;
+        std::deque<RawMessage> items;
+        int credit = 0;
+        uint64_t pushed = 0;
+        uint64_t dropped = 0;
+        LatencyHistogram latency;
+        std::condition_variable not_full;  // lane별 생산자 대기 (다른 lane 생산자를 깨우지 않도록)
+        size_t blocked_producers = 0;
+    };
+
+    // smooth weighted round-robin (mutex_ 보유 상태, 비어있지 않은 lane이 하나 이상)
+    size_t select_lane() {
+        int total = 0;
+        size_t best = lanes_.size();
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            Lane& lane = *lanes_[i];
+            if (lane.items.empty()) {
+                continue;
+            }
+            lane.credit += lane.spec.weight;
+            total += lane.spec.weight;
+            if (best == lanes_.size() || lane.credit > lanes_[best]->credit) {
+                best = i;
+            }
+        }
+        lanes_[best]->credit -= total;
+        return best;
+    }
+
+    static std::vector<LaneSpec> parse(const std::string& spec, size_t default_capacity) {
+        std::vector<LaneSpec> out;
+        std::stringstream lanes(spec);
+        std::string entry;
+
+        while (std::getline(lanes, entry, ';')) {
+            if (entry.find_first_not_of(" \t") == std::string::npos) {
+                continue;
+            }
+
+            std::vector<std::string> fields;
+            std::stringstream parts(entry);
+            for (std::string f; std::getline(parts, f, ':');) {
+                fields.push_back(f);
+            }
+            if (fields.size() < 2 || fields.size() > 5) {
+                throw std::invalid_argument("QUEUE_LANES 형식 오류: " + entry);
+            }
+
+            LaneSpec ls;
+            ls.name = trim(fields[0]);
+            std::stringstream classes(fields[1]);
+            for (std::string c; classes >> c;) {
+                ls.classes.push_back(parse_class(c));
+            }
+            ls.capacity = fields.size() > 2 && !trim(fields[2]).empty()
+                ? std::stoul(fields[2]) : default_capacity;
+            ls.weight = fields.size() > 3 ? std::max(1, std::stoi(fields[3])) : 1;
+            ls.batch_timeout_ms = fields.size() > 4 ? std::stoul(fields[4]) : 0;
+            out.push_back(std::move(ls));
+        }
+        return out;
+    }
+
+    // "S/F", "S/*", "*"
+    static std::pair<int, int> parse_class(const std::string& c) {
+        if (c == "*") {
+            return {-1, -1};
+        }
+        auto slash = c.find('/');
+        if (slash == std::string::npos) {
+            throw std::invalid_argument("QUEUE_LANES 클래스 형식 오류: " + c);
+        }
+        auto num = [](const std::string& s) { return s == "*" ? -1 : std::stoi(s); };
+        return {num(c.substr(0, slash)), num(c.substr(slash + 1))};
+    }
+
+    static std::string trim(const std::string& s) {
+        auto b = s.find_first_not_of(" \t");
+        auto e = s.find_last_not_of(" \t");
+        return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+    }
+
+private:
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::array<uint8_t, kStreams * kFunctions> class_lane_;
+    size_t size_ = 0;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    bool closed_;
+};
+
+} // namespace secs
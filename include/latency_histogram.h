@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace secs {
+
+// 지연 시간 히스토그램 (ns, 락 없음)
+// 2의 거듭제곱 구간을 4등분한 로그 버킷 → 상대 오차 25% 이내
+// 여러 워커가 동시에 record() 해도 안전하다.
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBits = 2;
+    static constexpr size_t kSub = 1 << kSubBits;
+    static constexpr size_t kBuckets = 64 * kSub;
+
+    LatencyHistogram() {
+        reset();
+    }
+
+    void record(uint64_t ns) {
+        buckets_[bucket_of(ns)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t prev = max_ns_.load(std::memory_order_relaxed);
+        while (ns > prev && !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    // 분위수 (해당 버킷 상한, ns)
+    uint64_t percentile(double q) const {
+        uint64_t total = count();
+        if (total == 0) {
+            return 0;
+        }
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total));
+        if (rank >= total) {
+            rank = total - 1;
+        }
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > rank) {
+                return std::min(upper_bound_of(i), max_ns_.load(std::memory_order_relaxed));
+            }
+        }
+        return max_ns_.load(std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for (auto& b : buckets_) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        count_.store(0, std::memory_order_relaxed);
+        sum_ns_.store(0, std::memory_order_relaxed);
+        max_ns_.store(0, std::memory_order_relaxed);
+    }
+
+    // 마이크로초 단위 요약
+    nlohmann::json stats() const {
+        uint64_t n = count();
+        auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+        return {
+            {"count", n},
+            {"mean_us", n ? us(sum_ns_.load(std::memory_order_relaxed) / n) : 0.0},
+            {"p50_us", us(percentile(0.50))},
+            {"p90_us", us(percentile(0.90))},
+            {"p99_us", us(percentile(0.99))},
+            {"p999_us", us(percentile(0.999))},
+            {"max_us", us(max_ns_.load(std::memory_order_relaxed))}
+        };
+    }
+
+private:
+    static size_t bucket_of(uint64_t v) {
+        if (v < kSub) {
+            return static_cast<size_t>(v);
+        }
+        size_t msb = 63 - static_cast<size_t>(__builtin_clzll(v));
+        size_t sub = static_cast<size_t>(v >> (msb - kSubBits)) & (kSub - 1);
+        return (msb - kSubBits + 1) * kSub + sub;
+    }
+
+    static uint64_t upper_bound_of(size_t idx) {
+        if (idx < kSub) {
+            return idx;
+        }
+        size_t msb = idx / kSub + kSubBits - 1;
+        uint64_t sub = idx % kSub;
+        uint64_t step = 1ull << (msb - kSubBits);
+        return ((kSub + sub) << (msb - kSubBits)) + step - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<uint64_t> max_ns_;
+};
+
+} // namespace secs
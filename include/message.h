@@ -4,6 +4,7 @@
 #include <string>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <netinet/in.h>
 
 namespace secs {
 
@@ -12,6 +13,9 @@ using json = nlohmann::json;
 // 원본 UDP 패킷
 struct RawMessage {
     std::vector<uint8_t> data;
+    uint64_t recv_ns = 0;  // 수신 시각 (steady clock, 지연 측정 / 추적용)
+    uint8_t lane = 0;      // 우선순위 lane (수신 시 헤더로 분류)
+    sockaddr_in source{};  // 송신 주소 (S2F50 응답용, 캡처 재생은 비어 있음)
     
     RawMessage() = default;
     
@@ -26,6 +30,7 @@ struct RawMessage {
 struct ParsedMessage {
     int stream;
     int function;
+    bool wbit;
     std::string timestamp;
     int device_id;
     std::string system_bytes;
@@ -38,6 +43,7 @@ struct ParsedMessage {
     static void extract_common(const json& msg, ParsedMessage& out) {
         out.stream = msg.value("stream", 0);
         out.function = msg.value("function", 0);
+        out.wbit = msg.value("wbit", false);
         out.timestamp = msg.value("timestamp", "");
         out.device_id = msg.value("deviceId", 0);
         out.system_bytes = msg.value("systemBytes", "");
@@ -0,0 +1,182 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "parser.h"
+#include "header_peek.h"
+#include "route_rules.h"
+#include "event_aggregator.h"
+#include "carrier_state_cache.h"
+#include "ack_sender.h"
+#include "sink_factory.h"
+#include "tracer.h"
+#include <spdlog/spdlog.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// 메시지 처리 단계 (스레드 전용 인스턴스: WorkerPool 워커 / per-core 스레드)
+// 헤더 peek → 라우팅 → 파싱 → 집계 / 상태 캐시 / S2F50 응답 → 배치 → sink fan-out
+// 배치 마감 시점은 호출측이 결정한다.
+// sink 기록 실패는 sink별로 격리한다 (다른 sink는 계속 기록, 스레드는 유지).
+// 상태 캐시 committed / S2F50 commit 응답은 모든 sink가 성공한 배치에만 적용된다
+// (비동기 sink가 있으면 committed는 그 sink가 커밋 후 직접 반영).
+class MessagePipeline {
+public:
+    MessagePipeline(const Config& cfg, std::string name, size_t id, const RouteTable& routes,
+                    EventAggregator* aggregator, CarrierStateCache* state_cache,
+                    AckSender* acks = nullptr)
+        : name_(std::move(name))
+        , routes_(routes)
+        , aggregator_(aggregator)
+        , state_cache_(state_cache)
+        , acks_(acks && acks->enabled() ? acks : nullptr)
+        , sinks_(make_sinks(cfg, id))
+        , sink_failures_(sinks_.size(), 0)
+        , commits_on_write_(true)
+    {
+        batch_.reserve(cfg.batch_size);
+        for (const auto& sink : sinks_) {
+            commits_on_write_ = commits_on_write_ && sink->commits_on_write();
+        }
+    }
+
+    // 배치에 추가 (false = 라우팅 규칙에 의해 drop)
+    bool add(RawMessage&& msg) {
+        // 헤더만 먼저 스캔하여 라우팅 (body 파싱 전에 drop / raw 결정)
+        RouteAction action = RouteAction::Parse;
+        if (auto hdr = HeaderPeek::peek(msg.bytes(), msg.size())) {
+            action = routes_.route(*hdr);
+        }
+
+        if (action == RouteAction::Drop) {
+            return false;
+        }
+
+        // 파싱
+        std::shared_ptr<ParsedMessage> parsed;
+        if (action == RouteAction::Parse) {
+            TraceScope trace("parse");
+            parsed = MessageParser::parse(msg);
+        }
+
+        if (aggregator_) {
+            if (auto s6f11 = std::dynamic_pointer_cast<S6F11Message>(parsed)) {
+                aggregator_->add(*s6f11);
+            }
+        }
+        if (state_cache_) {
+            if (auto s2f49 = std::dynamic_pointer_cast<S2F49Message>(parsed)) {
+                state_cache_->update(*s2f49);
+            }
+        }
+        if (acks_ && parsed) {
+            acks_->on_parsed(msg, *parsed);
+        }
+
+        batch_.raw_messages.push_back(std::move(msg));
+        batch_.parsed_messages.push_back(std::move(parsed));
+        return true;
+    }
+
+    size_t pending() const { return batch_.size(); }
+
+    // 모든 sink에 배치 기록 (fan-out) 후 배치 리셋
+    // after_write: 기록 완료 직후, 배치를 비우기 전 호출 (지연 측정 등)
+    void flush(const std::function<void(const MessageBatch&)>& after_write = nullptr) {
+        if (batch_.size() == 0) {
+            return;
+        }
+
+        bool all_written = true;
+        {
+            TraceScope trace("batch_flush", batch_.size());
+            uint64_t bytes = 0;
+            for (size_t i = 0; i < sinks_.size(); ++i) {
+                try {
+                    sinks_[i]->write_batch(batch_);
+                }
+                catch (const std::exception& e) {
+                    all_written = false;
+                    sink_failures_[i]++;
+                    spdlog::error("{}: {} 배치 기록 실패 ({}건 유실, 누적 {}회): {}",
+                                  name_, sinks_[i]->name(), batch_.size(), sink_failures_[i], e.what());
+                }
+                bytes += sinks_[i]->bytes_written();
+            }
+            bytes_written_ = bytes;
+        }
+        if (all_written) {
+            inserted_ += batch_.size();
+            if (commits_on_write_) {
+                mark_committed();
+            }
+            if (acks_) {
+                acks_->on_committed(batch_);
+            }
+        } else {
+            failed_batches_++;
+        }
+
+        if (after_write) {
+            after_write(batch_);
+        }
+
+        spdlog::debug("{}: 배치 {}건 처리 완료", name_, batch_.size());
+        batch_.clear();
+    }
+
+    // 종료 시 sink 버퍼 기록 + 통계 로그 (남은 배치는 호출측이 먼저 flush)
+    void finish() {
+        for (size_t i = 0; i < sinks_.size(); ++i) {
+            auto& sink = sinks_[i];
+            try {
+                sink->flush();
+            }
+            catch (const std::exception& e) {
+                sink_failures_[i]++;
+                spdlog::error("{}: {} flush 실패: {}", name_, sink->name(), e.what());
+            }
+            uint64_t written = sink->total_written();
+            spdlog::info("{} 종료 - {}: 총 {}건, {}B/msg, 실패 배치 {}",
+                        name_, sink->name(), written,
+                        written ? sink->bytes_written() / written : 0, sink_failures_[i]);
+        }
+    }
+
+    uint64_t inserted() const { return inserted_; }
+    uint64_t failed_batches() const { return failed_batches_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+
+private:
+    // DB 커밋 완료된 S2F49를 상태 캐시에 반영
+    void mark_committed() {
+        if (!state_cache_) {
+            return;
+        }
+        for (const auto& parsed : batch_.parsed_messages) {
+            if (auto s2f49 = std::dynamic_pointer_cast<S2F49Message>(parsed)) {
+                state_cache_->mark_committed(*s2f49);
+            }
+        }
+    }
+
+private:
+    std::string name_;
+    const RouteTable& routes_;
+    EventAggregator* aggregator_;
+    CarrierStateCache* state_cache_;
+    AckSender* acks_;
+    std::vector<std::unique_ptr<Sink>> sinks_;
+    std::vector<uint64_t> sink_failures_;  // sink별 실패 배치 수
+    bool commits_on_write_;                // 모든 sink가 write_batch 안에서 커밋
+    MessageBatch batch_;
+    uint64_t inserted_ = 0;
+    uint64_t failed_batches_ = 0;        // 하나 이상의 sink가 실패한 배치
+    uint64_t bytes_written_ = 0;  // sink 전송 바이트 합계
+};
+
+} // namespace secs
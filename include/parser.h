@@ -25,6 +25,9 @@ public:
             if (stream == 2 && function == 49) {
                 return parse_s2f49(msg);
             }
+            if (stream == 6 && function == 11) {
+                return parse_s6f11(msg);
+            }
             // 다른 메시지 타입들...
             
             spdlog::warn("지원되지 않는 메시지: S{}F{}", stream, function);
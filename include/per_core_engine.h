@@ -0,0 +1,404 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "ingress.h"
+#include "receiver.h"
+#include "message_pipeline.h"
+#include "tracer.h"
+#include <spdlog/spdlog.h>
+#include <pthread.h>
+#include <sched.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace secs {
+
+// Shared-nothing thread-per-core 실행 모드 (EXEC_MODE=per_core)
+//
+// 코어마다 SO_REUSEPORT UDP 소켓 / 파싱 / 배치 / sink(DB connection)를 하나씩 소유하고
+// 수신 스레드가 곧 처리 스레드다 (공유 큐 없음, 코어 간 패킷 이동 없음).
+// 커널이 4-tuple 해시로 흐름을 소켓에 분배하므로 한 장비의 패킷은 한 코어에서 처리된다.
+// 공유 상태: 설정 / 라우팅 규칙(읽기 전용), Ingress 통계(샤딩 / lock-free), 선택 기능(집계, 상태 캐시)
+class PerCoreEngine : public Receiver {
+public:
+    // recvmmsg 1회당 최대 데이터그램 수
+    static constexpr unsigned kRecvBatch = 64;
+    static constexpr size_t kDatagramSize = 65536;
+
+    PerCoreEngine(const Config& cfg, Ingress& ingress, const RouteTable& routes,
+                  EventAggregator* aggregator, CarrierStateCache* state_cache)
+        : config_(cfg)
+        , ingress_(ingress)
+        , routes_(routes)
+        , aggregator_(aggregator)
+        , state_cache_(state_cache)
+        , running_(false)
+    {
+        // 코어 수 / 고정 CPU는 프로세스에 허용된 CPU 집합 기준 (cgroup cpuset, taskset)
+        std::vector<int> cpus = allowed_cpus();
+        size_t count = cfg.core_count > 0 ? cfg.core_count : cpus.size();
+        if (count > cpus.size()) {
+            spdlog::warn("CORE_COUNT({})가 허용된 CPU 수({})보다 많음 - 일부 코어 스레드가 CPU를 공유",
+                         count, cpus.size());
+        }
+        for (size_t i = 0; i < count; ++i) {
+            auto core = std::make_unique<Core>();
+            core->id = i;
+            core->cpu = cpus[i % cpus.size()];
+            cores_.push_back(std::move(core));
+        }
+
+        // 모든 소켓을 먼저 bind (일부 코어만 수신하는 구간 방지)
+        // 생성자에서 열어 bind 실패가 수신 스레드가 아닌 호출측(main) 예외로 전달되도록 한다.
+        try {
+            for (auto& core : cores_) {
+                core->fd = open_socket();
+            }
+        }
+        catch (...) {
+            close_sockets();
+            throw;
+        }
+    }
+
+    ~PerCoreEngine() override {
+        close_sockets();
+    }
+
+    void start() override {
+        // S2F50 응답은 같은 포트의 첫 소켓으로 송신 (송신 주소 / 포트가 동일)
+        ingress_.attach_socket(cores_.front()->fd);
+
+        spdlog::info("UDP 수신 시작 (per-core): {}:{} ({} cores, SO_REUSEPORT)",
+                     config_.udp_host, config_.udp_port, cores_.size());
+
+        running_ = true;
+        std::vector<std::thread> threads;
+        for (auto& core : cores_) {
+            Core* raw = core.get();
+            threads.emplace_back([this, raw]() { core_main(*raw); });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    void stop() override {
+        // 각 코어가 poll 타임아웃마다 running_을 확인하므로 플래그만 내린다
+        running_ = false;
+    }
+
+    const char* backend_name() const override { return "per_core"; }
+
+    uint64_t total_received() const override { return sum(&Core::received); }
+    uint64_t total_bytes() const override { return sum(&Core::bytes); }
+    uint64_t total_syscalls() const override { return sum(&Core::syscalls); }
+
+    uint64_t cpu_time_ns() const override {
+        uint64_t total = 0;
+        for (const auto& core : cores_) {
+            total += core->cpu_clock.elapsed_ns();
+        }
+        return total;
+    }
+
+    // 코어별 통계 (합계는 Receiver 인터페이스로 조회)
+    json stats() const {
+        json cores = json::array();
+        for (const auto& core : cores_) {
+            cores.push_back({
+                {"core", core->id},
+                {"cpu", core->cpu},
+                {"received", core->received.load()},
+                {"inserted", core->inserted.load()},
+                {"failed_batches", core->failed_batches.load()},
+                {"pending", core->pending.load()},
+                {"bytes_written", core->bytes_written.load()}
+            });
+        }
+        return {
+            {"core_count", cores_.size()},
+            {"batch_size", config_.batch_size},
+            {"batch_timeout_ms", config_.batch_timeout_ms},
+            {"cores", cores}
+        };
+    }
+
+private:
+    struct Core {
+        size_t id = 0;
+        int cpu = 0;   // 고정 CPU (허용된 CPU 집합 안)
+        int fd = -1;
+        uint32_t last_drop_counter = 0;
+        ThreadCpuClock cpu_clock;
+
+        std::atomic<uint64_t> received{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> syscalls{0};
+        std::atomic<uint64_t> inserted{0};
+        std::atomic<uint64_t> failed_batches{0};
+        std::atomic<uint64_t> pending{0};
+        std::atomic<uint64_t> bytes_written{0};
+    };
+
+    // recvmmsg 버퍼 (코어 스레드 스택 대신 힙)
+    struct RecvBuffers {
+        std::array<mmsghdr, kRecvBatch> msgs{};
+        std::array<iovec, kRecvBatch> iovs{};
+        std::array<sockaddr_in, kRecvBatch> sources{};
+        std::vector<uint8_t> data = std::vector<uint8_t>(size_t(kRecvBatch) * kDatagramSize);
+        alignas(cmsghdr) std::array<uint8_t, kRecvBatch * Ingress::kControlLen> control{};
+
+        // recvmmsg 호출 전 길이 필드 재설정
+        void reset() {
+            for (unsigned i = 0; i < kRecvBatch; ++i) {
+                iovs[i] = {data.data() + size_t(i) * kDatagramSize, kDatagramSize};
+                msgs[i].msg_hdr = msghdr{};
+                msgs[i].msg_hdr.msg_name = &sources[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                msgs[i].msg_hdr.msg_control = control.data() + size_t(i) * Ingress::kControlLen;
+                msgs[i].msg_hdr.msg_controllen = Ingress::kControlLen;
+                msgs[i].msg_len = 0;
+            }
+        }
+    };
+
+    uint64_t sum(std::atomic<uint64_t> Core::*field) const {
+        uint64_t total = 0;
+        for (const auto& core : cores_) {
+            total += ((*core).*field).load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void close_sockets() {
+        for (auto& core : cores_) {
+            if (core->fd >= 0) {
+                ::close(core->fd);
+                core->fd = -1;
+            }
+        }
+    }
+
+    int open_socket() {
+        int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+        if (fd < 0) {
+            throw std::runtime_error(std::string("socket() 실패: ") + std::strerror(errno));
+        }
+
+        int one = 1;
+        if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0) {
+            ::close(fd);
+            throw std::runtime_error(std::string("SO_REUSEPORT 설정 실패: ") + std::strerror(errno));
+        }
+
+        int rcvbuf = 25 * 1024 * 1024;
+        ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        Ingress::enable_kernel_drop_counter(fd);
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config_.udp_port);
+        if (::inet_pton(AF_INET, config_.udp_host.c_str(), &addr.sin_addr) != 1) {
+            ::close(fd);
+            throw std::runtime_error("잘못된 UDP_HOST: " + config_.udp_host);
+        }
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            ::close(fd);
+            throw std::runtime_error(std::string("bind() 실패: ") + std::strerror(errno));
+        }
+        return fd;
+    }
+
+    // 프로세스에 허용된 CPU 번호 (조회 실패 시 0 ~ hardware_concurrency - 1)
+    static std::vector<int> allowed_cpus() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (::sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        } else {
+            spdlog::warn("허용 CPU 조회 실패: {}", std::strerror(errno));
+        }
+        if (cpus.empty()) {
+            for (unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); ++cpu) {
+                cpus.push_back(static_cast<int>(cpu));
+            }
+        }
+        return cpus;
+    }
+
+    // 코어 고정 (실패해도 계속 진행)
+    static void pin_to_cpu(int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            spdlog::warn("CPU {} 고정 실패: {}", cpu, std::strerror(rc));
+        }
+    }
+
+    void core_main(Core& core) {
+        std::string name = "Core #" + std::to_string(core.id);
+        Tracer::set_thread_name("core-" + std::to_string(core.id));
+        pin_to_cpu(core.cpu);
+        core.cpu_clock.attach();
+
+        // sink 오류는 MessagePipeline이 격리하므로 여기까지 오는 예외는 sink 생성 실패 (DB 연결 등)
+        // 코어 스레드는 재시도하며 소켓을 유지한다.
+        while (running_) {
+            try {
+                run_core(core, name);
+                break;
+            }
+            catch (const std::exception& e) {
+                spdlog::error("{} 오류: {} - 1초 후 재시작", name, e.what());
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+            }
+        }
+
+        // 종료 요청 없이 빠져나온 경우 (poll 오류): 소켓을 닫아 커널이 흐름을 남은 소켓으로 재분배하게 한다
+        if (running_) {
+            spdlog::error("{} 수신 중단 - 소켓을 닫고 흐름을 다른 코어로 넘김", name);
+            ::close(core.fd);
+            core.fd = -1;
+        }
+
+        core.cpu_clock.detach();
+    }
+
+    // 코어 처리 루프 (stop() 또는 poll 오류 시 남은 배치를 기록하고 반환)
+    void run_core(Core& core, const std::string& name) {
+        MessagePipeline pipeline(config_, name, core.id, routes_, aggregator_, state_cache_,
+                                 &ingress_.acks());
+        auto buffers = std::make_unique<RecvBuffers>();
+
+        auto batch_timeout = std::chrono::milliseconds(config_.batch_timeout_ms);
+        auto batch_deadline = std::chrono::steady_clock::now() + batch_timeout;
+
+        auto flush = [&]() {
+            pipeline.flush();
+            core.inserted.store(pipeline.inserted(), std::memory_order_relaxed);
+            core.failed_batches.store(pipeline.failed_batches(), std::memory_order_relaxed);
+            core.bytes_written.store(pipeline.bytes_written(), std::memory_order_relaxed);
+            core.pending.store(0, std::memory_order_relaxed);
+        };
+
+        spdlog::info("{} 시작 (sinks={})", name, config_.sinks);
+
+        while (running_) {
+            // 배치가 있으면 마감까지만, 없으면 stop() 확인 주기(100ms)까지 대기
+            int wait_ms = 100;
+            if (pipeline.pending() > 0) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    batch_deadline - std::chrono::steady_clock::now()).count();
+                wait_ms = static_cast<int>(std::clamp<int64_t>(left, 0, 100));
+            }
+
+            pollfd pfd{core.fd, POLLIN, 0};
+            int ready = ::poll(&pfd, 1, wait_ms);
+            core.syscalls.fetch_add(1, std::memory_order_relaxed);
+
+            if (ready > 0) {
+                receive(core, *buffers, pipeline, flush);
+            }
+            else if (ready < 0 && errno != EINTR) {
+                spdlog::error("{} poll 오류: {}", name, std::strerror(errno));
+                break;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            if (pipeline.pending() == 0) {
+                batch_deadline = now + batch_timeout;
+            }
+            else if (now >= batch_deadline) {
+                flush();
+                batch_deadline = now + batch_timeout;
+            }
+        }
+
+        // 종료 시 남은 배치 처리
+        if (size_t remaining = pipeline.pending()) {
+            flush();
+            spdlog::info("{}: 종료 전 남은 배치 {}건 처리", name, remaining);
+        }
+        pipeline.finish();
+    }
+
+    // 소켓 버퍼를 recvmmsg로 비우며 배치에 추가 (배치가 차면 즉시 기록)
+    template<typename Flush>
+    void receive(Core& core, RecvBuffers& buffers, MessagePipeline& pipeline, Flush& flush) {
+        while (running_) {
+            buffers.reset();
+            int n = ::recvmmsg(core.fd, buffers.msgs.data(), kRecvBatch, MSG_DONTWAIT, nullptr);
+            core.syscalls.fetch_add(1, std::memory_order_relaxed);
+            if (n <= 0) {
+                if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    spdlog::error("Core #{} 수신 오류: {}", core.id, std::strerror(errno));
+                }
+                return;
+            }
+
+            TraceScope trace("recv", static_cast<uint64_t>(n));
+            for (int i = 0; i < n; ++i) {
+                msghdr& hdr = buffers.msgs[i].msg_hdr;
+                for (cmsghdr* c = CMSG_FIRSTHDR(&hdr); c; c = CMSG_NXTHDR(&hdr, c)) {
+                    if (auto counter = Ingress::kernel_drop_counter(c)) {
+                        ingress_.on_kernel_drop_counter(*counter, core.last_drop_counter);
+                    }
+                }
+
+                const auto* data = static_cast<const uint8_t*>(buffers.iovs[i].iov_base);
+                size_t len = buffers.msgs[i].msg_len;
+                core.received.fetch_add(1, std::memory_order_relaxed);
+                core.bytes.fetch_add(len, std::memory_order_relaxed);
+
+                const sockaddr_in* source = hdr.msg_namelen >= sizeof(sockaddr_in) ? &buffers.sources[i] : nullptr;
+                if (auto msg = ingress_.admit(data, len, source)) {
+                    pipeline.add(std::move(*msg));
+                    if (pipeline.pending() >= config_.batch_size) {
+                        flush();
+                    }
+                }
+            }
+            core.pending.store(pipeline.pending(), std::memory_order_relaxed);
+
+            if (static_cast<unsigned>(n) < kRecvBatch) {
+                return;  // 소켓 버퍼 비움
+            }
+        }
+    }
+
+private:
+    const Config& config_;
+    Ingress& ingress_;
+    const RouteTable& routes_;
+    EventAggregator* aggregator_;
+    CarrierStateCache* state_cache_;
+
+    std::vector<std::unique_ptr<Core>> cores_;
+    std::atomic<bool> running_;
+};
+
+} // namespace secs
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// deviceId별 token bucket (수신 단계, 큐 투입 전)
+//
+// 고정 크기 open addressing 테이블 + 슬롯당 GCRA 상태 1개 (atomic CAS, 락 없음)
+// GCRA는 token bucket과 동치: rate = 초당 허용 건수, burst = 순간 허용 건수
+//   tat(이론적 다음 도착 시각) - now > (burst - 1) / rate  →  throttle
+// rate 0 = 제한 없음. 장비별 override는 기본값보다 우선한다.
+// 테이블이 가득 차면 새 장비는 제한하지 않는다 (untracked로 집계).
+class DeviceRateLimiter {
+public:
+    // overrides: "17=5000/10000,23=0" (deviceId=rate[/burst])
+    DeviceRateLimiter(size_t rate, size_t burst, const std::string& overrides, size_t table_size)
+        : default_rate_(static_cast<int64_t>(rate))
+        , default_burst_(static_cast<int64_t>(burst))
+        , override_count_(0)
+        , used_(0)
+        , untracked_(0)
+        , total_throttled_(0)
+    {
+        size_t cap = 1;
+        while (cap < table_size) {
+            cap <<= 1;
+        }
+        mask_ = cap - 1;
+        slots_ = std::make_unique<Slot[]>(cap);
+
+        std::stringstream ss(overrides);
+        for (std::string entry; std::getline(ss, entry, ',');) {
+            if (entry.find_first_not_of(" \t") == std::string::npos) {
+                continue;
+            }
+            auto eq = entry.find('=');
+            if (eq == std::string::npos) {
+                throw std::invalid_argument("RATE_LIMIT_OVERRIDES 형식 오류: " + entry);
+            }
+            auto [r, b] = parse_rate(entry.substr(eq + 1));
+            set_device(std::stoi(entry.substr(0, eq)), r, b);
+        }
+    }
+
+    // 제한이 하나라도 걸려 있는지 (아니면 수신 단계에서 헤더를 읽을 필요 없음)
+    bool enabled() const {
+        return default_rate_.load(std::memory_order_relaxed) > 0 ||
+               override_count_.load(std::memory_order_relaxed) > 0;
+    }
+
+    // 수신 스레드에서 메시지마다 호출, false = throttle
+    bool allow(int device_id, uint64_t now_ns) {
+        Slot* slot = find(device_id, true);
+        if (!slot) {
+            untracked_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        int64_t rate = slot->rate.load(std::memory_order_relaxed);
+        int64_t burst = slot->burst.load(std::memory_order_relaxed);
+        if (rate < 0) {
+            rate = default_rate_.load(std::memory_order_relaxed);
+            burst = default_burst_.load(std::memory_order_relaxed);
+        }
+        if (rate == 0) {
+            slot->allowed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        if (burst <= 0) {
+            burst = rate;
+        }
+
+        uint64_t interval = 1000000000ull / static_cast<uint64_t>(rate);
+        uint64_t tolerance = interval * static_cast<uint64_t>(burst - 1);
+
+        uint64_t tat = slot->tat.load(std::memory_order_relaxed);
+        while (true) {
+            uint64_t t = std::max(tat, now_ns);
+            if (t - now_ns > tolerance) {
+                slot->throttled.fetch_add(1, std::memory_order_relaxed);
+                total_throttled_.fetch_add(1, std::memory_order_relaxed);
+                if (!slot->limited.exchange(true, std::memory_order_relaxed)) {
+                    spdlog::warn("장비 {} 수신 제한 시작 (rate={}/s, burst={})", device_id, rate, burst);
+                }
+                return false;
+            }
+            if (slot->tat.compare_exchange_weak(tat, t + interval, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        slot->allowed.fetch_add(1, std::memory_order_relaxed);
+
+        // bucket이 다시 가득 찬 뒤에야 제한 해제로 본다 (throttle 중 간헐 허용은 무시)
+        if (tat <= now_ns && slot->limited.load(std::memory_order_relaxed)) {
+            slot->limited.store(false, std::memory_order_relaxed);
+            spdlog::info("장비 {} 수신 제한 해제", device_id);
+        }
+        return true;
+    }
+
+    // 런타임 변경 (제어 소켓)
+    void set_default(size_t rate, size_t burst) {
+        default_burst_.store(static_cast<int64_t>(burst), std::memory_order_relaxed);
+        default_rate_.store(static_cast<int64_t>(rate), std::memory_order_relaxed);
+        spdlog::info("장비 수신 제한 기본값: rate={}/s, burst={}", rate, burst);
+    }
+
+    void set_device(int device_id, size_t rate, size_t burst) {
+        Slot* slot = find(device_id, true);
+        if (!slot) {
+            throw std::runtime_error("장비 테이블 가득 참 (RATE_LIMIT_TABLE_SIZE 증가 필요)");
+        }
+        slot->burst.store(static_cast<int64_t>(burst), std::memory_order_relaxed);
+        if (slot->rate.exchange(static_cast<int64_t>(rate), std::memory_order_relaxed) < 0) {
+            override_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        spdlog::info("장비 {} 수신 제한: rate={}/s, burst={}", device_id, rate, burst);
+    }
+
+    // override 제거 (기본값 적용)
+    void clear_device(int device_id) {
+        if (Slot* slot = find(device_id, false)) {
+            if (slot->rate.exchange(-1, std::memory_order_relaxed) >= 0) {
+                override_count_.fetch_sub(1, std::memory_order_relaxed);
+            }
+            slot->burst.store(-1, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t total_throttled() const { return total_throttled_.load(std::memory_order_relaxed); }
+
+    // "rate[/burst]"
+    static std::pair<size_t, size_t> parse_rate(const std::string& s) {
+        auto slash = s.find('/');
+        size_t rate = std::stoul(s.substr(0, slash));
+        size_t burst = slash == std::string::npos ? 0 : std::stoul(s.substr(slash + 1));
+        return {rate, burst};
+    }
+
+    // throttle 횟수 상위 장비 + override 장비
+    nlohmann::json stats(size_t top = 50) const {
+        struct Row { int device; int64_t rate, burst; uint64_t allowed, throttled; };
+        std::vector<Row> rows;
+        for (size_t i = 0; i <= mask_; ++i) {
+            const Slot& s = slots_[i];
+            int64_t key = s.key.load(std::memory_order_acquire);
+            if (key == kEmpty) {
+                continue;
+            }
+            int64_t rate = s.rate.load(std::memory_order_relaxed);
+            uint64_t throttled = s.throttled.load(std::memory_order_relaxed);
+            if (throttled > 0 || rate >= 0) {
+                rows.push_back({static_cast<int>(key), rate, s.burst.load(std::memory_order_relaxed),
+                                s.allowed.load(std::memory_order_relaxed), throttled});
+            }
+        }
+        std::sort(rows.begin(), rows.end(),
+                  [](const Row& a, const Row& b) { return a.throttled > b.throttled; });
+        if (rows.size() > top) {
+            rows.resize(top);
+        }
+
+        nlohmann::json devices = nlohmann::json::array();
+        for (const auto& r : rows) {
+            nlohmann::json d = {
+                {"device_id", r.device},
+                {"allowed", r.allowed},
+                {"throttled", r.throttled}
+            };
+            if (r.rate >= 0) {
+                d["rate"] = r.rate;
+                d["burst"] = r.burst;
+            }
+            devices.push_back(std::move(d));
+        }
+
+        return {
+            {"rate", default_rate_.load()},
+            {"burst", default_burst_.load()},
+            {"tracked_devices", used_.load()},
+            {"table_size", mask_ + 1},
+            {"untracked", untracked_.load()},
+            {"throttled", total_throttled()},
+            {"devices", devices}
+        };
+    }
+
+private:
+    static constexpr int64_t kEmpty = std::numeric_limits<int64_t>::min();
+
+    struct Slot {
+        std::atomic<int64_t> key{kEmpty};
+        std::atomic<uint64_t> tat{0};      // GCRA theoretical arrival time (ns)
+        std::atomic<int64_t> rate{-1};     // -1 = 기본값 사용
+        std::atomic<int64_t> burst{-1};
+        std::atomic<uint64_t> allowed{0};
+        std::atomic<uint64_t> throttled{0};
+        std::atomic<bool> limited{false};  // 제한 상태 전환 로그용
+    };
+
+    // linear probing, insert 시 빈 슬롯을 CAS로 선점
+    Slot* find(int device_id, bool insert) {
+        int64_t key = device_id;
+        size_t idx = (static_cast<uint32_t>(device_id) * 0x9E3779B1u) & mask_;
+        for (size_t probe = 0; probe <= mask_; ++probe, idx = (idx + 1) & mask_) {
+            Slot& s = slots_[idx];
+            int64_t cur = s.key.load(std::memory_order_acquire);
+            if (cur == key) {
+                return &s;
+            }
+            if (cur == kEmpty) {
+                if (!insert) {
+                    return nullptr;
+                }
+                if (s.key.compare_exchange_strong(cur, key, std::memory_order_acq_rel)) {
+                    used_.fetch_add(1, std::memory_order_relaxed);
+                    return &s;
+                }
+                if (cur == key) {
+                    return &s;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    std::unique_ptr<Slot[]> slots_;
+    size_t mask_;
+    std::atomic<int64_t> default_rate_;
+    std::atomic<int64_t> default_burst_;
+    std::atomic<int64_t> override_count_;
+    std::atomic<size_t> used_;
+    std::atomic<uint64_t> untracked_;
+    std::atomic<uint64_t> total_throttled_;
+};
+
+} // namespace secs
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <pthread.h>
+#include <time.h>
+#include <atomic>
+#include <cstdint>
+
+namespace secs {
+
+// 수신 엔진 공통 인터페이스 (Boost.Asio / io_uring)
+class Receiver {
+public:
+    virtual ~Receiver() = default;
+
+    // 수신 루프 실행 (블로킹, stop() 호출 시 반환)
+    virtual void start() = 0;
+    virtual void stop() = 0;
+
+    // 입력이 끝났는지 여부 (캡처 재생처럼 유한한 입력만 true가 됨)
+    virtual bool finished() const { return false; }
+
+    virtual const char* backend_name() const = 0;
+
+    virtual uint64_t total_received() const = 0;
+    virtual uint64_t total_bytes() const = 0;
+
+    // 엔진이 직접 센 수신 호출 수 (recvmsg / io_uring 대기, 운영 통계용 근사치)
+    // 커널 진입 여부와 epoll_wait는 반영하지 않으므로 백엔드 비교는 recv-bench의 커널 카운터를 쓴다.
+    virtual uint64_t total_syscalls() const = 0;
+
+    // 수신 스레드가 사용한 CPU 시간 (ns)
+    virtual uint64_t cpu_time_ns() const = 0;
+
+    // 수신 버퍼보다 커서 버린 데이터그램
+    virtual uint64_t total_truncated() const { return 0; }
+};
+
+// 수신 스레드 CPU 시간 측정 (다른 스레드에서 조회 가능)
+class ThreadCpuClock {
+public:
+    // 수신 스레드 안에서 호출
+    void attach() {
+        clockid_t clk;
+        if (pthread_getcpuclockid(pthread_self(), &clk) == 0) {
+            clock_id_ = clk;
+            attached_ = true;
+        }
+    }
+
+    // 수신 스레드 종료 직전에 호출 (이후 clock id는 무효)
+    void detach() {
+        final_ns_ = read();
+        attached_ = false;
+    }
+
+    uint64_t elapsed_ns() const {
+        return attached_ ? read() : final_ns_.load();
+    }
+
+private:
+    uint64_t read() const {
+        timespec ts{};
+        if (!attached_ || clock_gettime(clock_id_, &ts) != 0) {
+            return final_ns_.load();
+        }
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + ts.tv_nsec;
+    }
+
+    clockid_t clock_id_{};
+    std::atomic<bool> attached_{false};
+    std::atomic<uint64_t> final_ns_{0};
+};
+
+} // namespace secs
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "ingress.h"
+#include "receiver.h"
+#include "udp_receiver.h"
+#include "uring_receiver.h"
+#include "replay_source.h"
+#include <spdlog/spdlog.h>
+#include <memory>
+
+namespace secs {
+
+// 입력 소스 선택
+// - REPLAY_FILE 설정 시 캡처 파일 재생
+// - 그 외 RECV_BACKEND 설정에 따라 수신 엔진 선택 (io_uring 불가 시 Asio로 fallback)
+inline std::unique_ptr<Receiver> make_receiver(const Config& cfg, Ingress& ingress) {
+    if (!cfg.replay_file.empty()) {
+        return std::make_unique<ReplaySource>(cfg, ingress);
+    }
+
+    if (cfg.recv_backend == "io_uring") {
+#ifdef SECS_HAVE_IO_URING
+        if (UringReceiver::supported()) {
+            return std::make_unique<UringReceiver>(cfg, ingress);
+        }
+        spdlog::warn("io_uring multishot recvmsg 미지원 커널 - Asio 수신으로 fallback");
+#else
+        spdlog::warn("io_uring 미포함 빌드 (liburing 없음) - Asio 수신으로 fallback");
+#endif
+    }
+    else if (cfg.recv_backend != "asio") {
+        spdlog::warn("알 수 없는 RECV_BACKEND '{}' - Asio 사용", cfg.recv_backend);
+    }
+
+    return std::make_unique<UdpReceiver>(cfg, ingress);
+}
+
+} // namespace secs
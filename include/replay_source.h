@@ -0,0 +1,117 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "ingress.h"
+#include "receiver.h"
+#include "capture_reader.h"
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace secs {
+
+// 캡처 파일 재생 (오프라인 backfill)
+// UDP 소켓 대신 캡처 파일의 데이터그램을 같은 큐 → WorkerPool → DB 경로로 투입한다.
+// - REPLAY_SPEED=0 : 최대 속도, 큐가 가득 차면 push()에서 대기 (드롭 없음)
+// - REPLAY_SPEED>0 : 원본 도착 간격을 배속 적용하여 재현 (pcap 타임스탬프 필요)
+class ReplaySource : public Receiver {
+public:
+    ReplaySource(const Config& cfg, Ingress& ingress)
+        : config_(cfg)
+        , ingress_(ingress)
+        , running_(false)
+        , finished_(false)
+        , total_received_(0)
+        , total_bytes_(0)
+    {}
+
+    void start() override {
+        // 파일 열기 / 형식 오류는 수신 스레드 밖으로 던지지 않고 종료로 처리 (main이 정상 종료)
+        try {
+            replay();
+        }
+        catch (const std::exception& e) {
+            spdlog::error("캡처 재생 실패: {}", e.what());
+        }
+        finished_ = true;
+    }
+
+    void stop() override {
+        running_ = false;
+    }
+
+    bool finished() const override { return finished_.load(); }
+
+    const char* backend_name() const override { return "replay"; }
+
+    uint64_t total_received() const override { return total_received_.load(); }
+    uint64_t total_bytes() const override { return total_bytes_.load(); }
+    uint64_t total_syscalls() const override { return 0; }  // mmap 읽기
+    uint64_t cpu_time_ns() const override { return cpu_clock_.elapsed_ns(); }
+
+private:
+    void replay() {
+        CaptureReader reader(config_.replay_file, config_.replay_format, config_.replay_filter_port);
+
+        spdlog::info("캡처 재생 시작: {} ({}, {}B, speed={})",
+                     config_.replay_file,
+                     reader.format() == CaptureReader::Format::Pcap ? "pcap" : "raw",
+                     reader.file_size(),
+                     config_.replay_speed > 0 ? std::to_string(config_.replay_speed) + "x" : "max");
+
+        running_ = true;
+        cpu_clock_.attach();
+        Tracer::set_thread_name("replay");
+
+        auto started = std::chrono::steady_clock::now();
+        auto wall_origin = started;
+        int64_t ts_origin = -1;
+        bool paced = config_.replay_speed > 0;
+
+        while (running_) {
+            auto rec = reader.next();
+            if (!rec) {
+                break;
+            }
+
+            if (paced && rec->has_ts) {
+                if (ts_origin < 0) {
+                    ts_origin = rec->ts_ns;
+                    wall_origin = std::chrono::steady_clock::now();
+                }
+                auto offset = std::chrono::nanoseconds(
+                    static_cast<int64_t>((rec->ts_ns - ts_origin) / config_.replay_speed));
+                std::this_thread::sleep_until(wall_origin + offset);
+            }
+
+            total_received_++;
+            total_bytes_ += rec->len;
+
+            // 블로킹 push → 파이프라인 속도에 맞춰 backpressure (시퀀스 추적은 UDP와 동일)
+            if (!ingress_.deliver_blocking(rec->data, rec->len)) {
+                break;  // 큐 닫힘 (종료 중)
+            }
+        }
+
+        cpu_clock_.detach();
+
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        spdlog::info("캡처 재생 완료: {}건 ({}B), 건너뜀 {}건, {:.1f}s ({:.0f} msg/s)",
+                     total_received_.load(), total_bytes_.load(), reader.skipped(),
+                     secs, secs > 0 ? total_received_.load() / secs : 0.0);
+    }
+
+private:
+    const Config& config_;
+    Ingress& ingress_;
+
+    std::atomic<bool> running_;
+    std::atomic<bool> finished_;
+    std::atomic<uint64_t> total_received_;
+    std::atomic<uint64_t> total_bytes_;
+    ThreadCpuClock cpu_clock_;
+};
+
+} // namespace secs
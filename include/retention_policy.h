@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace secs {
+
+// secs_raw_messages 보관 방식
+enum class RawRetention {
+    Full,    // 헤더 + raw_body 전체
+    Header,  // 헤더만 (raw_body NULL) - 파싱 테이블과의 연결(raw_message_id)은 유지
+    Sample,  // N건 중 1건만 raw_body 보관, 나머지는 Header
+    None     // raw row 없음 (파싱 테이블의 raw_message_id는 NULL)
+};
+
+struct RetentionRule {
+    RawRetention mode = RawRetention::Full;
+    uint32_t sample_n = 1;
+};
+
+// (stream, function)별 raw 메시지 보관 정책
+//
+// RAW_RETENTION 형식: "<S>/<F>=<mode>;..." (default 키는 나머지 전체)
+//   mode: full | header | none | sample:<N>
+//   예) "default=full;6/11=sample:100;2/49=none;1/1=header"
+//
+// Sample 카운터는 정책 인스턴스(워커)별로 독립 → 전체적으로도 N건 중 1건
+class RetentionPolicy {
+public:
+    explicit RetentionPolicy(const std::string& spec) {
+        std::istringstream iss(spec);
+        std::string entry;
+        while (std::getline(iss, entry, ';')) {
+            if (entry.empty()) {
+                continue;
+            }
+            auto eq = entry.find('=');
+            if (eq == std::string::npos) {
+                throw std::invalid_argument("RAW_RETENTION 항목 형식 오류: " + entry);
+            }
+            std::string key = entry.substr(0, eq);
+            RetentionRule rule = parse_rule(entry.substr(eq + 1));
+
+            if (key == "default") {
+                default_ = rule;
+                continue;
+            }
+            auto slash = key.find('/');
+            if (slash == std::string::npos) {
+                throw std::invalid_argument("RAW_RETENTION 키 형식 오류: " + key);
+            }
+            int stream = std::stoi(key.substr(0, slash));
+            int function = std::stoi(key.substr(slash + 1));
+            rules_[make_key(stream, function)] = Entry{rule, 0};
+        }
+    }
+
+    // 이번 메시지의 보관 방식 결정 (Sample은 Full/Header 중 하나로 확정)
+    RawRetention decide(int stream, int function) {
+        auto it = rules_.find(make_key(stream, function));
+        if (it == rules_.end()) {
+            return resolve(default_, default_counter_);
+        }
+        return resolve(it->second.rule, it->second.counter);
+    }
+
+private:
+    struct Entry {
+        RetentionRule rule;
+        uint64_t counter;
+    };
+
+    static uint32_t make_key(int stream, int function) {
+        return (static_cast<uint32_t>(stream) << 8) | static_cast<uint32_t>(function & 0xff);
+    }
+
+    static RetentionRule parse_rule(const std::string& text) {
+        RetentionRule rule;
+        if (text == "full") {
+            rule.mode = RawRetention::Full;
+        } else if (text == "header") {
+            rule.mode = RawRetention::Header;
+        } else if (text == "none") {
+            rule.mode = RawRetention::None;
+        } else if (text.rfind("sample:", 0) == 0) {
+            rule.mode = RawRetention::Sample;
+            rule.sample_n = static_cast<uint32_t>(std::stoul(text.substr(7)));
+            if (rule.sample_n == 0) {
+                rule.sample_n = 1;
+            }
+        } else {
+            throw std::invalid_argument("알 수 없는 RAW_RETENTION 모드: " + text);
+        }
+        return rule;
+    }
+
+    static RawRetention resolve(const RetentionRule& rule, uint64_t& counter) {
+        if (rule.mode != RawRetention::Sample) {
+            return rule.mode;
+        }
+        return (counter++ % rule.sample_n == 0) ? RawRetention::Full : RawRetention::Header;
+    }
+
+private:
+    RetentionRule default_;
+    uint64_t default_counter_ = 0;
+    std::unordered_map<uint32_t, Entry> rules_;
+};
+
+} // namespace secs
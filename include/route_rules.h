@@ -0,0 +1,142 @@
+#pragma once
+
+#include "header_peek.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// 헤더 확인 후 처리 방식
+enum class RouteAction {
+    Drop,     // 저장하지 않음
+    RawOnly,  // body 파싱 없이 secs_raw_messages만 저장
+    Parse     // 전체 파싱 후 타입별 테이블까지 저장
+};
+
+// 헤더(stream, function, deviceId) 기반 라우팅 규칙 테이블
+//
+// ROUTE_RULES 형식: "<S>/<F>[@<deviceId>]=<drop|raw|parse>;..." ('*'는 와일드카드)
+//   먼저 선언된 규칙이 우선, 일치하는 규칙이 없으면 default (기본 parse)
+//   예) "1/1=drop;1/2=drop;5/*@17=drop;5/*=raw;default=parse"
+//
+// 규칙별 적중 카운터는 모든 워커가 공유 (relaxed atomic)
+class RouteTable {
+public:
+    static constexpr int kAny = -1;
+
+    explicit RouteTable(const std::string& spec) {
+        std::istringstream iss(spec);
+        std::string entry;
+        while (std::getline(iss, entry, ';')) {
+            if (entry.empty()) {
+                continue;
+            }
+            auto eq = entry.find('=');
+            if (eq == std::string::npos) {
+                throw std::invalid_argument("ROUTE_RULES 항목 형식 오류: " + entry);
+            }
+            std::string key = entry.substr(0, eq);
+            RouteAction action = parse_action(entry.substr(eq + 1));
+
+            if (key == "default") {
+                default_.action = action;
+                continue;
+            }
+
+            auto rule = std::make_unique<Rule>();
+            rule->text = entry;
+            rule->action = action;
+
+            std::string sf = key;
+            auto at = key.find('@');
+            if (at != std::string::npos) {
+                rule->device_id = parse_field(key.substr(at + 1));
+                sf = key.substr(0, at);
+            }
+            auto slash = sf.find('/');
+            if (slash == std::string::npos) {
+                throw std::invalid_argument("ROUTE_RULES 키 형식 오류: " + key);
+            }
+            rule->stream = parse_field(sf.substr(0, slash));
+            rule->function = parse_field(sf.substr(slash + 1));
+            rules_.push_back(std::move(rule));
+        }
+        default_.text = "default";
+    }
+
+    RouteAction route(const MessageHeader& hdr) const {
+        for (const auto& rule : rules_) {
+            if (matches(*rule, hdr)) {
+                rule->hits.fetch_add(1, std::memory_order_relaxed);
+                return rule->action;
+            }
+        }
+        default_.hits.fetch_add(1, std::memory_order_relaxed);
+        return default_.action;
+    }
+
+    // 규칙별 적중 카운터
+    nlohmann::json stats() const {
+        nlohmann::json out = nlohmann::json::array();
+        for (const auto& rule : rules_) {
+            out.push_back(rule_stats(*rule));
+        }
+        out.push_back(rule_stats(default_));
+        return out;
+    }
+
+private:
+    struct Rule {
+        std::string text;
+        int stream = kAny;
+        int function = kAny;
+        int device_id = kAny;
+        RouteAction action = RouteAction::Parse;
+        mutable std::atomic<uint64_t> hits{0};
+    };
+
+    static bool matches(const Rule& rule, const MessageHeader& hdr) {
+        return (rule.stream == kAny || rule.stream == hdr.stream) &&
+               (rule.function == kAny || rule.function == hdr.function) &&
+               (rule.device_id == kAny || rule.device_id == hdr.device_id);
+    }
+
+    static int parse_field(const std::string& text) {
+        return text == "*" ? kAny : std::stoi(text);
+    }
+
+    static RouteAction parse_action(const std::string& text) {
+        if (text == "drop") return RouteAction::Drop;
+        if (text == "raw") return RouteAction::RawOnly;
+        if (text == "parse") return RouteAction::Parse;
+        throw std::invalid_argument("알 수 없는 ROUTE_RULES 동작: " + text);
+    }
+
+    static const char* action_name(RouteAction action) {
+        switch (action) {
+            case RouteAction::Drop:    return "drop";
+            case RouteAction::RawOnly: return "raw";
+            case RouteAction::Parse:   return "parse";
+        }
+        return "unknown";
+    }
+
+    static nlohmann::json rule_stats(const Rule& rule) {
+        return {
+            {"rule", rule.text},
+            {"action", action_name(rule.action)},
+            {"hits", rule.hits.load(std::memory_order_relaxed)}
+        };
+    }
+
+private:
+    std::vector<std::unique_ptr<Rule>> rules_;
+    Rule default_;
+};
+
+} // namespace secs
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "header_peek.h"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+namespace secs {
+
+// deviceId별 systemBytes 시퀀스 추적 → 손실 원인 분리
+//
+// 장비는 systemBytes를 1씩 증가시키므로, 수신 스레드에서 본 시퀀스의 빈 구간은
+// "커널 버퍼 드롭 + 업스트림(네트워크/송신측) 손실"이다.
+//   kernel  : SO_RXQ_OVFL 카운터 (소켓 단위, 장비 구분 불가)
+//   queue   : 수신은 했지만 큐가 가득 차 버린 메시지 (장비별)
+//   upstream: 시퀀스 빈 구간 합계 - kernel (전체 기준 추정치)
+// 최근 64개 시퀀스는 비트맵으로 유지하여 중복과 늦게 도착한 패킷(순서 뒤바뀜)을 구분한다.
+// 장비 상태는 deviceId로 샤딩 (per-core 모드에서 여러 수신 스레드가 동시에 갱신)
+class SequenceTracker {
+public:
+    // 이보다 큰 점프는 장비 재시작 / 카운터 리셋으로 간주
+    static constexpr int64_t kResetThreshold = 1 << 20;
+
+    explicit SequenceTracker(int system_bytes_base)
+        : base_(system_bytes_base)
+        , kernel_drops_(0)
+        , unparsed_(0)
+    {}
+
+    // 수신 스레드에서 데이터그램마다 호출
+    void on_received(const MessageHeader& hdr) {
+        uint32_t seq;
+        std::string_view sb = hdr.system_bytes;
+        if (sb.size() > 2 && sb[0] == '0' && (sb[1] == 'x' || sb[1] == 'X')) {
+            sb.remove_prefix(2);
+        }
+        auto [ptr, ec] = std::from_chars(sb.data(), sb.data() + sb.size(), seq, base_);
+        if (sb.empty() || ec != std::errc() || ptr != sb.data() + sb.size()) {
+            unparsed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Shard& shard = shard_of(hdr.device_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.devices[hdr.device_id].observe(seq);
+    }
+
+    void on_queue_drop(int device_id) {
+        Shard& shard = shard_of(device_id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.devices[device_id].queue_drops++;
+    }
+
+    // SO_RXQ_OVFL 증가분
+    void add_kernel_drops(uint64_t delta) {
+        kernel_drops_.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    uint64_t kernel_drops() const { return kernel_drops_.load(std::memory_order_relaxed); }
+
+    // 장비별 / 원인별 손실 리포트
+    nlohmann::json report() const {
+        nlohmann::json devices = nlohmann::json::array();
+        uint64_t missing = 0;
+        uint64_t queue_drops = 0;
+
+        for (const auto& shard : shards_) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (const auto& [id, d] : shard.devices) {
+                devices.push_back({
+                    {"device_id", id},
+                    {"received", d.received},
+                    {"missing", d.missing},
+                    {"duplicates", d.duplicates},
+                    {"reordered", d.reordered},
+                    {"max_reorder_distance", d.max_reorder},
+                    {"queue_drops", d.queue_drops},
+                    {"resets", d.resets}
+                });
+                missing += d.missing;
+                queue_drops += d.queue_drops;
+            }
+        }
+
+        uint64_t kernel = kernel_drops();
+        return {
+            {"loss", {
+                {"kernel_buffer", kernel},
+                {"queue_full", queue_drops},
+                {"upstream_gap", missing > kernel ? missing - kernel : 0},
+                {"sequence_missing", missing}
+            }},
+            {"unparsed_system_bytes", unparsed_.load(std::memory_order_relaxed)},
+            {"devices", devices}
+        };
+    }
+
+private:
+    struct DeviceSeq {
+        bool init = false;
+        uint32_t highest = 0;
+        uint64_t window = 0;  // bit i = (highest - i) 수신 여부
+
+        uint64_t received = 0;
+        uint64_t missing = 0;      // 아직 도착하지 않은 시퀀스 수 (늦게 도착하면 감소)
+        uint64_t duplicates = 0;
+        uint64_t reordered = 0;
+        uint64_t max_reorder = 0;
+        uint64_t queue_drops = 0;
+        uint64_t resets = 0;
+
+        void observe(uint32_t seq) {
+            received++;
+            if (!init) {
+                init = true;
+                highest = seq;
+                window = 1;
+                return;
+            }
+
+            // 32비트 wrap-around 고려한 거리
+            int64_t d = static_cast<int32_t>(seq - highest);
+
+            if (d > kResetThreshold || d < -kResetThreshold) {
+                resets++;
+                highest = seq;
+                window = 1;
+                return;
+            }
+
+            if (d > 0) {
+                missing += static_cast<uint64_t>(d - 1);
+                window = d >= 64 ? 0 : (window << d);
+                window |= 1;
+                highest = seq;
+            }
+            else if (d == 0) {
+                duplicates++;
+            }
+            else {
+                uint64_t dist = static_cast<uint64_t>(-d);
+                if (dist < 64) {
+                    uint64_t bit = 1ull << dist;
+                    if (window & bit) {
+                        duplicates++;
+                        return;
+                    }
+                    window |= bit;
+                }
+                // 빈 구간으로 집계됐던 시퀀스가 늦게 도착
+                reordered++;
+                if (missing > 0) {
+                    missing--;
+                }
+                if (dist > max_reorder) {
+                    max_reorder = dist;
+                }
+            }
+        }
+    };
+
+    static constexpr size_t kShards = 64;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<int, DeviceSeq> devices;
+    };
+
+    Shard& shard_of(int device_id) {
+        return shards_[(static_cast<uint32_t>(device_id) * 0x9E3779B1u) >> 26];
+    }
+
+private:
+    const int base_;
+    std::array<Shard, kShards> shards_;
+    std::atomic<uint64_t> kernel_drops_;
+    std::atomic<uint64_t> unparsed_;
+};
+
+} // namespace secs
@@ -0,0 +1,511 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "sink.h"
+#include "db_writer.h"
+#include "bounded_queue.h"
+#include "carrier_state_cache.h"
+#include "header_peek.h"
+#include "latency_histogram.h"
+#include "tracer.h"
+#include <spdlog/spdlog.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace secs {
+
+// deviceId 기준 PostgreSQL 샤딩 (DB_TARGETS 설정 시 postgres sink)
+//
+// - 장비 → 샤드: DB_SHARD_MAP 지정값 우선, 없으면 deviceId 해시의 jump consistent hash
+//   (대상을 N → N+1개로 늘리면 약 1/(N+1)의 장비만 새 샤드로 이동)
+// - 샤드마다 전용 큐 + writer 스레드 DB_POOL_SIZE개 (스레드당 connection 1개)
+//   writer가 여러 워커의 하위 배치를 BATCH_SIZE까지 모아 한 트랜잭션으로 기록
+// - 워커는 하위 배치를 샤드 큐에 넣고 바로 돌아간다 (느린 샤드는 자기 큐만 채움,
+//   큐가 가득 찬 샤드의 하위 배치는 버리고 dropped로 집계 - 다른 샤드는 계속 기록)
+// - 연결 실패 / 끊김 시 배치를 유지하고 재시도
+// - 기록(SQL) 실패 시 재연결 후 1회 재시도, 다시 실패하면 메시지 단위로 기록하여 문제 row만 버린다
+// - 상태 캐시 committed는 샤드 커밋 후 writer가 반영 (set_state_cache)
+class ShardedDbWriter {
+public:
+    struct Target {
+        std::string host;
+        uint16_t port;
+        std::string dbname;
+
+        std::string label() const {
+            return host + ":" + std::to_string(port) + "/" + dbname;
+        }
+    };
+
+    explicit ShardedDbWriter(const Config& cfg)
+        : config_(cfg)
+        , stopped_(false)
+    {
+        for (auto& target : parse_targets(cfg.db_targets, cfg.db_name)) {
+            auto shard = std::make_unique<Shard>(cfg.db_shard_queue);
+            shard->id = shards_.size();
+            shard->target = std::move(target);
+            shards_.push_back(std::move(shard));
+        }
+        if (shards_.empty()) {
+            throw std::invalid_argument("DB_TARGETS가 비어 있음");
+        }
+        device_map_ = parse_shard_map(cfg.db_shard_map, shards_.size());
+
+        size_t pool = std::max<size_t>(cfg.db_pool_size, 1);
+        for (auto& shard : shards_) {
+            for (size_t i = 0; i < pool; ++i) {
+                Shard* raw = shard.get();
+                shard->writers.emplace_back([this, raw, i]() { writer_main(*raw, i); });
+            }
+            spdlog::info("DB 샤드 #{}: {} (writers={})", shard->id, shard->target.label(), pool);
+        }
+    }
+
+    ~ShardedDbWriter() {
+        stop();
+    }
+
+    // 여러 sink(워커 / 코어)가 공유하는 프로세스 단일 인스턴스
+    static std::shared_ptr<ShardedDbWriter> shared(const Config& cfg) {
+        static std::mutex mutex;
+        static std::weak_ptr<ShardedDbWriter> instance;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto writer = instance.lock();
+        if (!writer) {
+            writer = std::make_shared<ShardedDbWriter>(cfg);
+            instance = writer;
+        }
+        return writer;
+    }
+
+    size_t shard_count() const { return shards_.size(); }
+
+    // 샤드 커밋 완료된 S2F49를 반영할 상태 캐시 (nullptr = 없음)
+    void set_state_cache(CarrierStateCache* cache) {
+        state_cache_.store(cache, std::memory_order_release);
+    }
+
+    // 장비 → 샤드 (재시작 / 버전과 무관하게 안정적)
+    size_t shard_of(int device_id) const {
+        if (auto it = device_map_.find(device_id); it != device_map_.end()) {
+            return it->second;
+        }
+        return jump_hash(mix(static_cast<uint64_t>(static_cast<uint32_t>(device_id))), shards_.size());
+    }
+
+    // 배치를 샤드별 하위 배치로 나누어 큐에 넣는다 (false = 종료 후 호출)
+    // 큐가 가득 찬 샤드의 하위 배치는 기다리지 않고 버린다 (죽은 샤드가 워커를 막지 않도록)
+    bool submit(const MessageBatch& batch) {
+        std::vector<MessageBatch> parts(shards_.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const auto& parsed = batch.parsed_messages[i];
+            const auto& raw = batch.raw_messages[i];
+            int device_id = 0;
+            if (parsed) {
+                device_id = parsed->device_id;
+            } else if (auto hdr = HeaderPeek::peek(raw.bytes(), raw.size())) {
+                device_id = hdr->device_id;
+            }
+            MessageBatch& part = parts[shard_of(device_id)];
+            part.raw_messages.push_back(raw);
+            part.parsed_messages.push_back(parsed);
+        }
+
+        bool ok = true;
+        for (size_t s = 0; s < parts.size(); ++s) {
+            if (parts[s].size() == 0) {
+                continue;
+            }
+            Shard& shard = *shards_[s];
+            size_t n = parts[s].size();
+            if (shard.queue.try_push(std::move(parts[s]))) {
+                shard.enqueued.fetch_add(n, std::memory_order_relaxed);
+            } else if (stopped_.load()) {
+                shard.rejected.fetch_add(n, std::memory_order_relaxed);
+                ok = false;
+            } else {
+                uint64_t dropped = shard.dropped.fetch_add(n, std::memory_order_relaxed);
+                if (dropped / kDropLogEvery != (dropped + n) / kDropLogEvery || dropped == 0) {
+                    spdlog::warn("DB 샤드 #{} 큐 가득 참 - {}건 드롭 (누적 {}건)",
+                                 shard.id, n, dropped + n);
+                }
+            }
+        }
+        return ok;
+    }
+
+    // 큐를 닫고 남은 하위 배치를 모두 기록한 뒤 writer 종료
+    void stop() {
+        if (stopped_.exchange(true)) {
+            return;
+        }
+        for (auto& shard : shards_) {
+            shard->queue.close();
+        }
+        for (auto& shard : shards_) {
+            for (auto& t : shard->writers) {
+                if (t.joinable()) {
+                    t.join();
+                }
+            }
+            spdlog::info("DB 샤드 #{} 종료 - {}: 총 {}건, 미기록 {}건 (실패 배치 {}), 큐 초과 드롭 {}건",
+                         shard->id, shard->target.label(), shard->written.load(),
+                         shard->failed.load(), shard->failed_batches.load(), shard->dropped.load());
+        }
+    }
+
+    json stats() const {
+        json shards = json::array();
+        for (const auto& shard : shards_) {
+            shards.push_back({
+                {"shard", shard->id},
+                {"target", shard->target.label()},
+                {"writers", shard->writers.size()},
+                {"connected", shard->connected.load()},
+                {"queued_batches", shard->queue.size()},
+                {"queue_capacity", shard->queue.capacity()},
+                {"enqueued", shard->enqueued.load()},
+                {"written", shard->written.load()},
+                {"failed", shard->failed.load()},
+                {"failed_batches", shard->failed_batches.load()},
+                {"dropped", shard->dropped.load()},
+                {"rejected", shard->rejected.load()},
+                {"retries", shard->retries.load()},
+                {"reconnects", shard->reconnects.load()},
+                {"commit_latency", shard->commit_latency.stats()},
+                {"end_to_end_latency", shard->e2e_latency.stats()}
+            });
+        }
+        return {
+            {"shard_count", shards_.size()},
+            {"mapped_devices", device_map_.size()},
+            {"shards", shards}
+        };
+    }
+
+private:
+    static constexpr uint64_t kDropLogEvery = 10000;  // 큐 초과 드롭 경고 간격 (건)
+
+    struct Shard {
+        explicit Shard(size_t queue_capacity) : queue(queue_capacity) {}
+
+        size_t id = 0;
+        Target target;
+        BoundedQueue<MessageBatch> queue;  // 하위 배치 단위
+        std::vector<std::thread> writers;
+
+        std::atomic<size_t> connected{0};
+        std::atomic<uint64_t> enqueued{0};
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> failed_batches{0};  // 메시지 단위 재기록으로 넘어간 배치
+        std::atomic<uint64_t> dropped{0};         // 큐 가득 참으로 버린 메시지
+        std::atomic<uint64_t> rejected{0};
+        std::atomic<uint64_t> retries{0};         // SQL 오류 후 재시도한 배치
+        std::atomic<uint64_t> reconnects{0};
+        LatencyHistogram commit_latency;   // 트랜잭션 1회 기록 시간
+        LatencyHistogram e2e_latency;      // 수신 → 커밋 (메시지별)
+    };
+
+    void writer_main(Shard& shard, size_t index) {
+        std::string name = "DB 샤드 #" + std::to_string(shard.id) + "-" + std::to_string(index);
+        Tracer::set_thread_name("db-shard-" + std::to_string(shard.id) + "-" + std::to_string(index));
+
+        std::unique_ptr<DatabaseWriter> db;
+        auto timeout = std::chrono::milliseconds(config_.batch_timeout_ms);
+        MessageBatch batch;
+        batch.reserve(config_.batch_size);
+        bool closed = false;
+        bool disconnected = false;
+        bool held = false;     // 실패 후 다시 기록할 배치 (하위 배치를 더 모으지 않음)
+        bool retried = false;  // SQL 오류로 이미 1회 재시도한 배치
+
+        while (!closed || batch.size() > 0) {
+            // 하위 배치를 BATCH_SIZE까지 모은다 (첫 하위 배치 이후 BATCH_TIMEOUT_MS까지)
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (!closed && !held && batch.size() < config_.batch_size) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+                auto part = shard.queue.pop(batch.size() == 0 ? std::chrono::milliseconds(100)
+                                                              : std::max(left, std::chrono::milliseconds(0)));
+                if (!part) {
+                    closed = stopped_.load() && shard.queue.size() == 0;
+                    if (batch.size() > 0 || closed) {
+                        break;
+                    }
+                    deadline = std::chrono::steady_clock::now() + timeout;
+                    continue;
+                }
+                for (size_t i = 0; i < part->size(); ++i) {
+                    batch.raw_messages.push_back(std::move(part->raw_messages[i]));
+                    batch.parsed_messages.push_back(std::move(part->parsed_messages[i]));
+                }
+            }
+            if (batch.size() == 0) {
+                continue;
+            }
+
+            // 연결 실패 시 배치를 유지한 채 재시도 (그동안 이 샤드 큐만 찬다)
+            if (!db) {
+                try {
+                    db = std::make_unique<DatabaseWriter>(config_, shard.target.host, shard.target.port,
+                                                          shard.target.dbname);
+                    shard.connected.fetch_add(1, std::memory_order_relaxed);
+                    if (disconnected) {
+                        shard.reconnects.fetch_add(1, std::memory_order_relaxed);
+                        spdlog::info("{} 재연결", name);
+                    }
+                    disconnected = false;
+                }
+                catch (const std::exception& e) {
+                    if (!disconnected) {
+                        spdlog::error("{} 연결 실패 - 재시도 중: {}", name, e.what());
+                    }
+                    disconnected = true;
+                    if (!stopped_.load()) {
+                        held = true;
+                        std::this_thread::sleep_for(std::chrono::seconds(1));
+                        continue;
+                    }
+                    // 종료 중 연결 불가: 남은 하위 배치를 모두 버리고 끝낸다
+                    uint64_t dropped = batch.size();
+                    while (auto part = shard.queue.pop(std::chrono::milliseconds(0))) {
+                        dropped += part->size();
+                    }
+                    spdlog::error("{} 종료 - 연결 불가로 미기록 {}건 드롭", name, dropped);
+                    shard.failed.fetch_add(dropped, std::memory_order_relaxed);
+                    batch.clear();
+                    held = false;
+                    closed = true;
+                    continue;
+                }
+            }
+
+            try {
+                commit(shard, *db, batch);
+            }
+            catch (const pqxx::broken_connection& e) {
+                // 배치를 유지한 채 재연결 후 다시 기록
+                spdlog::error("{} 연결 끊김 ({}건 보류): {}", name, batch.size(), e.what());
+                disconnect(shard, db);
+                disconnected = true;
+                held = true;
+                continue;
+            }
+            catch (const std::exception& e) {
+                disconnect(shard, db);
+                disconnected = true;
+                if (!retried) {
+                    // 일시적 오류(교착, 직렬화 실패 등)일 수 있으므로 새 연결로 1회 재시도
+                    spdlog::warn("{} 기록 실패 ({}건) - 재연결 후 재시도: {}", name, batch.size(), e.what());
+                    shard.retries.fetch_add(1, std::memory_order_relaxed);
+                    held = true;
+                    retried = true;
+                    continue;
+                }
+                // 재시도도 실패: 메시지 단위로 기록하여 문제 row만 버린다
+                spdlog::error("{} 재시도 실패 ({}건) - 메시지 단위로 재기록: {}", name, batch.size(), e.what());
+                shard.failed_batches.fetch_add(1, std::memory_order_relaxed);
+                try {
+                    db = std::make_unique<DatabaseWriter>(config_, shard.target.host, shard.target.port,
+                                                          shard.target.dbname);
+                    shard.connected.fetch_add(1, std::memory_order_relaxed);
+                    disconnected = false;
+                }
+                catch (const std::exception&) {
+                    held = true;
+                    continue;
+                }
+                if (!commit_each(shard, *db, batch, name)) {
+                    // 도중에 연결이 끊기면 남은 메시지만 보류
+                    disconnect(shard, db);
+                    disconnected = true;
+                    held = true;
+                    continue;
+                }
+            }
+            batch.clear();
+            held = false;
+            retried = false;
+        }
+
+        if (db) {
+            shard.connected.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // 배치 1회 기록 + 통계 / 상태 캐시 반영 (실패 시 예외)
+    void commit(Shard& shard, DatabaseWriter& db, const MessageBatch& batch) {
+        uint64_t begin = Tracer::now_ns();
+        db.insert_batch(batch);
+        uint64_t now = Tracer::now_ns();
+
+        shard.commit_latency.record(now - begin);
+        for (const auto& raw : batch.raw_messages) {
+            if (raw.recv_ns != 0 && now > raw.recv_ns) {
+                shard.e2e_latency.record(now - raw.recv_ns);
+            }
+        }
+        shard.written.fetch_add(batch.size(), std::memory_order_relaxed);
+
+        if (auto* cache = state_cache_.load(std::memory_order_acquire)) {
+            for (const auto& parsed : batch.parsed_messages) {
+                if (auto s2f49 = std::dynamic_pointer_cast<S2F49Message>(parsed)) {
+                    cache->mark_committed(*s2f49);
+                }
+            }
+        }
+    }
+
+    // 메시지마다 별도 트랜잭션으로 기록, 실패한 메시지만 버린다
+    // 연결이 끊기면 false (batch에는 아직 기록하지 않은 메시지만 남긴다)
+    bool commit_each(Shard& shard, DatabaseWriter& db, MessageBatch& batch, const std::string& name) {
+        uint64_t bad = 0;
+        for (size_t i = 0; i < batch.size(); ++i) {
+            MessageBatch one;
+            one.raw_messages.push_back(batch.raw_messages[i]);
+            one.parsed_messages.push_back(batch.parsed_messages[i]);
+            try {
+                commit(shard, db, one);
+            }
+            catch (const pqxx::broken_connection&) {
+                auto n = static_cast<std::ptrdiff_t>(i);
+                batch.raw_messages.erase(batch.raw_messages.begin(), batch.raw_messages.begin() + n);
+                batch.parsed_messages.erase(batch.parsed_messages.begin(), batch.parsed_messages.begin() + n);
+                spdlog::error("{} 메시지 단위 재기록 중 연결 끊김 - {}건 드롭, {}건 보류",
+                              name, bad, batch.size());
+                return false;
+            }
+            catch (const std::exception&) {
+                bad++;
+                shard.failed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        spdlog::error("{} 메시지 단위 재기록 완료 - {}건 중 {}건 드롭", name, batch.size(), bad);
+        return true;
+    }
+
+    static void disconnect(Shard& shard, std::unique_ptr<DatabaseWriter>& db) {
+        if (db) {
+            db.reset();
+            shard.connected.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // "host:port[/dbname],..." (dbname 생략 시 DB_NAME)
+    static std::vector<Target> parse_targets(const std::string& spec, const std::string& default_db) {
+        std::vector<Target> targets;
+        std::stringstream ss(spec);
+        for (std::string entry; std::getline(ss, entry, ',');) {
+            auto b = entry.find_first_not_of(" \t");
+            if (b == std::string::npos) {
+                continue;
+            }
+            entry = entry.substr(b, entry.find_last_not_of(" \t") - b + 1);
+
+            Target t;
+            t.dbname = default_db;
+            auto slash = entry.find('/');
+            if (slash != std::string::npos) {
+                t.dbname = entry.substr(slash + 1);
+                entry = entry.substr(0, slash);
+            }
+            auto colon = entry.rfind(':');
+            if (colon == std::string::npos) {
+                throw std::invalid_argument("DB_TARGETS 형식 오류 (host:port[/dbname]): " + entry);
+            }
+            t.host = entry.substr(0, colon);
+            t.port = static_cast<uint16_t>(std::stoi(entry.substr(colon + 1)));
+            targets.push_back(std::move(t));
+        }
+        return targets;
+    }
+
+    // "deviceId=shard,..." (shard = DB_TARGETS 순서, 0부터)
+    static std::unordered_map<int, size_t> parse_shard_map(const std::string& spec, size_t shard_count) {
+        std::unordered_map<int, size_t> map;
+        std::stringstream ss(spec);
+        for (std::string entry; std::getline(ss, entry, ',');) {
+            if (entry.find_first_not_of(" \t") == std::string::npos) {
+                continue;
+            }
+            auto eq = entry.find('=');
+            if (eq == std::string::npos) {
+                throw std::invalid_argument("DB_SHARD_MAP 형식 오류: " + entry);
+            }
+            size_t shard = std::stoul(entry.substr(eq + 1));
+            if (shard >= shard_count) {
+                throw std::invalid_argument("DB_SHARD_MAP 샤드 번호 범위 초과: " + entry);
+            }
+            map[std::stoi(entry.substr(0, eq))] = shard;
+        }
+        return map;
+    }
+
+    // splitmix64 finalizer (연속된 deviceId를 고르게 분산)
+    static uint64_t mix(uint64_t x) {
+        x += 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // Lamping & Veach jump consistent hash
+    static size_t jump_hash(uint64_t key, size_t buckets) {
+        int64_t b = -1;
+        int64_t j = 0;
+        while (j < static_cast<int64_t>(buckets)) {
+            b = j;
+            key = key * 2862933555777941757ull + 1;
+            j = static_cast<int64_t>((b + 1) * (double(1ll << 31) / double((key >> 33) + 1)));
+        }
+        return static_cast<size_t>(b);
+    }
+
+private:
+    const Config& config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unordered_map<int, size_t> device_map_;  // 생성 후 읽기 전용
+    std::atomic<bool> stopped_;
+    std::atomic<CarrierStateCache*> state_cache_{nullptr};
+};
+
+// 샤딩된 PostgreSQL sink (워커 / 코어별 인스턴스, writer는 공유)
+class ShardedDbSink : public Sink {
+public:
+    explicit ShardedDbSink(const Config& cfg)
+        : writer_(ShardedDbWriter::shared(cfg))
+    {}
+
+    const char* name() const override { return "postgres"; }
+
+    // 샤드 큐에 넣으면 반환 (커밋은 샤드 writer가 비동기로 수행)
+    void write_batch(const MessageBatch& batch) override {
+        if (!writer_->submit(batch)) {
+            throw std::runtime_error("DB 샤드 종료됨 - 배치 거부");
+        }
+        total_written_ += batch.size();
+    }
+
+    uint64_t total_written() const override { return total_written_; }
+
+    // 커밋은 샤드 writer가 수행 (상태 캐시 committed도 그때 반영)
+    bool commits_on_write() const override { return false; }
+
+private:
+    std::shared_ptr<ShardedDbWriter> writer_;
+    uint64_t total_written_ = 0;
+};
+
+} // namespace secs
@@ -0,0 +1,438 @@
+#pragma once
+
+// 공유 메모리 ring (단일 생산자 / 다중 소비자)
+//
+// 수신기가 파싱한 메시지를 고정 크기 바이너리 레코드로 발행하고, 같은 호스트의
+// 소비자 프로세스가 DB 조회 없이 읽는다. 이 헤더는 수신기 의존성(spdlog / json)이
+// 없으므로 소비자는 이 파일만 include 하면 된다 (POSIX shm_open / mmap).
+//
+// 메모리 배치 (/dev/shm/<name>)
+//   [0, 4096)        RingHeader
+//   [4096, ...)      slot_count개 슬롯 × slot_size 바이트
+//   slot             Slot { stamp } + Record + payload
+//
+// 슬롯마다 seqlock: 시퀀스 n을 쓰는 동안 stamp = 2n+1, 완료 후 2n+2.
+// 생산자는 소비자를 기다리지 않는다. 느린 소비자는 stamp가 기대값보다 크면
+// overrun으로 감지하고 최신 쪽으로 건너뛴다 (유실 건수 집계).
+// 생산자가 다른 geometry로 재시작하면 기존 객체에 replaced를 표시하고 새 객체를 만든다.
+// 기존 매핑의 소비자는 Replaced를 받고 다시 attach 한다.
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace secs::shm {
+
+constexpr uint32_t kMagic = 0x52434553;  // "SECR"
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderSize = 4096;
+
+struct RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;               // 2의 거듭제곱
+    uint32_t slot_size;                // 64의 배수
+    uint64_t created_ns;               // ring 생성 시각 (CLOCK_REALTIME)
+    std::atomic<uint32_t> replaced;    // 1 = 새 ring으로 교체됨 (이 매핑에는 더 이상 쓰지 않음)
+    alignas(64) std::atomic<uint64_t> write_seq;  // 발행 완료된 건수 (= 다음 시퀀스)
+};
+
+enum RecordKind : uint8_t {
+    kOther = 0,
+    kS2F49 = 1,
+    kS6F11 = 2
+};
+
+// 문자열 필드는 고정 길이, NUL 종료 (길면 잘림)
+struct S2F49Fields {
+    int32_t txn_code;
+    int32_t priority;
+    char txn_id[32];
+    char command_type[32];
+    char command_id[64];
+    char carrier_id[64];
+    char source[64];
+    char dest[64];
+    char source_type[16];
+    char dest_type[16];
+};
+
+struct S6F11Fields {
+    int32_t event_report_id;
+    int32_t event_id;
+};
+
+// 고정 레이아웃 레코드 (little-endian, 같은 호스트 전용)
+struct Record {
+    uint64_t seq;
+    uint64_t recv_ns;        // 수신 시각 (CLOCK_MONOTONIC, 프로세스 간 비교 가능)
+    int32_t device_id;
+    uint8_t stream;
+    uint8_t function;
+    uint8_t wbit;
+    uint8_t kind;            // RecordKind
+    uint16_t payload_len;    // Record 뒤에 이어지는 payload 바이트
+    uint8_t truncated;       // payload가 슬롯보다 커서 잘림
+    uint8_t reserved[5];
+    char system_bytes[16];
+    char timestamp[32];
+    union {
+        S2F49Fields s2f49;
+        S6F11Fields s6f11;
+    };
+
+    // S6F11: data_items JSON 텍스트
+    std::string_view payload() const {
+        return {reinterpret_cast<const char*>(this + 1), payload_len};
+    }
+};
+
+struct Slot {
+    std::atomic<uint64_t> stamp;
+    uint64_t reserved;
+    Record record;
+};
+
+static_assert(sizeof(RingHeader) <= kHeaderSize);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(offsetof(Slot, record) == 16);
+
+// 고정 길이 문자열 필드 → view
+template<size_t N>
+inline std::string_view field(const char (&s)[N]) {
+    return {s, strnlen(s, N)};
+}
+
+template<size_t N>
+inline void set_field(char (&dst)[N], std::string_view src) {
+    size_t n = std::min(src.size(), N - 1);
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+namespace detail {
+
+inline size_t mapping_size(uint32_t slot_count, uint32_t slot_size) {
+    return kHeaderSize + size_t(slot_count) * slot_size;
+}
+
+inline Slot* slot_at(void* base, uint32_t slot_size, uint64_t index) {
+    return reinterpret_cast<Slot*>(static_cast<uint8_t*>(base) + kHeaderSize + index * slot_size);
+}
+
+} // namespace detail
+
+// 생산자 (수신기 프로세스에 하나, 동시에 한 스레드만 begin/commit)
+class RingWriter {
+public:
+    // 같은 geometry의 ring이 이미 있으면 이어서 쓴다 (소비자 재attach 불필요)
+    // mode: shm 객체 권한 (기본 소유자만, 다른 사용자 소비자는 0640 등으로 허용)
+    RingWriter(const std::string& name, uint32_t slot_count, uint32_t slot_size, mode_t mode = 0600)
+        : name_(name)
+        , slot_count_(slot_count)
+        , slot_size_(slot_size)
+    {
+        if (slot_count == 0 || (slot_count & (slot_count - 1)) != 0) {
+            throw std::invalid_argument("SHM_RING_SLOTS는 2의 거듭제곱이어야 함");
+        }
+        if (slot_size % 64 != 0 || slot_size < sizeof(Slot) || slot_size - sizeof(Slot) > UINT16_MAX) {
+            throw std::invalid_argument("SHM_RING_SLOT_SIZE는 64의 배수, " +
+                                        std::to_string(sizeof(Slot)) + " ~ 65536");
+        }
+        if ((mode & ~mode_t(0777)) != 0) {
+            throw std::invalid_argument("SHM_RING_MODE는 0000~0777 (8진수)");
+        }
+
+        fd_ = ::shm_open(name.c_str(), O_CREAT | O_RDWR | O_CLOEXEC, mode);
+        if (fd_ < 0) {
+            throw std::runtime_error("shm_open 실패 (" + name + "): " + std::strerror(errno));
+        }
+
+        size_ = detail::mapping_size(slot_count, slot_size);
+        struct stat st{};
+        if (::fstat(fd_, &st) == 0 && st.st_size != 0 && static_cast<size_t>(st.st_size) != size_) {
+            // geometry 변경: 새 객체로 교체 (기존 소비자 매핑을 줄이면 SIGBUS)
+            // 기존 소비자가 멈춘 ring을 계속 기다리지 않도록 교체 표시 후 unlink
+            mark_replaced(fd_, static_cast<size_t>(st.st_size));
+            ::close(fd_);
+            ::shm_unlink(name.c_str());
+            fd_ = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, mode);
+            if (fd_ < 0) {
+                throw std::runtime_error("shm_open 실패 (" + name + "): " + std::strerror(errno));
+            }
+            st.st_size = 0;
+        }
+        bool reuse = static_cast<size_t>(st.st_size) == size_;
+        // 재사용하는 객체도 (이전 실행의 권한 대신) 지정한 권한으로 맞춘다
+        if (::fchmod(fd_, mode) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("shm 권한 설정 실패: " + std::string(std::strerror(errno)));
+        }
+        if (!reuse && ::ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("shm 크기 설정 실패: " + std::string(std::strerror(errno)));
+        }
+
+        base_ = ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base_ == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("shm mmap 실패: " + std::string(std::strerror(errno)));
+        }
+
+        header_ = static_cast<RingHeader*>(base_);
+        if (!reuse || header_->magic != kMagic || header_->version != kVersion ||
+            header_->slot_count != slot_count || header_->slot_size != slot_size) {
+            initialize();
+        }
+        seq_ = header_->write_seq.load(std::memory_order_relaxed);
+    }
+
+    ~RingWriter() {
+        if (base_ && base_ != MAP_FAILED) {
+            ::munmap(base_, size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    RingWriter(const RingWriter&) = delete;
+    RingWriter& operator=(const RingWriter&) = delete;
+
+    // payload 최대 크기
+    size_t payload_capacity() const { return slot_size_ - sizeof(Slot); }
+
+    // 다음 슬롯을 쓰기 상태로 전환하고 레코드 반환 (commit 전까지 소비자는 읽지 않음)
+    Record& begin() {
+        Slot* slot = detail::slot_at(base_, slot_size_, seq_ & (slot_count_ - 1));
+        slot->stamp.store(2 * seq_ + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Record& rec = slot->record;
+        std::memset(&rec, 0, sizeof(Record));
+        rec.seq = seq_;
+        return rec;
+    }
+
+    char* payload(Record& rec) {
+        return reinterpret_cast<char*>(&rec + 1);
+    }
+
+    void commit() {
+        Slot* slot = detail::slot_at(base_, slot_size_, seq_ & (slot_count_ - 1));
+        slot->stamp.store(2 * seq_ + 2, std::memory_order_release);
+        header_->write_seq.store(++seq_, std::memory_order_release);
+    }
+
+    uint64_t published() const { return seq_; }
+    const std::string& name() const { return name_; }
+
+private:
+    static void mark_replaced(int fd, size_t size) {
+        if (size < kHeaderSize) {
+            return;
+        }
+        void* old = ::mmap(nullptr, kHeaderSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (old == MAP_FAILED) {
+            return;
+        }
+        auto* header = static_cast<RingHeader*>(old);
+        if (header->magic == kMagic) {
+            header->replaced.store(1, std::memory_order_release);
+        }
+        ::munmap(old, kHeaderSize);
+    }
+
+    void initialize() {
+        std::memset(base_, 0, size_);
+        header_->version = kVersion;
+        header_->slot_count = slot_count_;
+        header_->slot_size = slot_size_;
+        timespec ts{};
+        ::clock_gettime(CLOCK_REALTIME, &ts);
+        header_->created_ns = static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + ts.tv_nsec;
+        header_->write_seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = kMagic;
+    }
+
+private:
+    std::string name_;
+    uint32_t slot_count_;
+    uint32_t slot_size_;
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    RingHeader* header_ = nullptr;
+    uint64_t seq_ = 0;
+};
+
+// 소비자 (프로세스 / 스레드마다 하나, 읽기 전용 매핑)
+//
+//   secs::shm::RingReader reader("/secs-ring");
+//   reader.subscribe(2, 49);
+//   while (running) {
+//       auto st = reader.read([](const secs::shm::Record& r) { ... });
+//       if (st == secs::shm::ReadStatus::Empty) usleep(100);
+//   }
+enum class ReadStatus {
+    Ok,        // 구독 레코드 1건 전달
+    Empty,     // 새 레코드 없음
+    Overrun,   // 생산자에게 추월당함 (lost()만큼 건너뜀, 직전 콜백 값은 버릴 것)
+    Replaced   // 생산자가 새 ring을 만듦 (RingReader를 다시 생성해 attach)
+};
+
+class RingReader {
+public:
+    // from_start = false면 attach 시점 이후 레코드부터 읽는다
+    explicit RingReader(const std::string& name, bool from_start = false) {
+        fd_ = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+        if (fd_ < 0) {
+            throw std::runtime_error("shm_open 실패 (" + name + "): " + std::strerror(errno));
+        }
+        struct stat st{};
+        if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < kHeaderSize) {
+            ::close(fd_);
+            throw std::runtime_error("ring이 아직 초기화되지 않음: " + name);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        base_ = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+        if (base_ == MAP_FAILED) {
+            ::close(fd_);
+            throw std::runtime_error("shm mmap 실패: " + std::string(std::strerror(errno)));
+        }
+
+        header_ = static_cast<const RingHeader*>(base_);
+        if (header_->magic != kMagic || header_->version != kVersion ||
+            detail::mapping_size(header_->slot_count, header_->slot_size) != size_) {
+            ::munmap(base_, size_);
+            ::close(fd_);
+            throw std::runtime_error("ring 형식 불일치: " + name);
+        }
+        mask_ = header_->slot_count - 1;
+        slot_size_ = header_->slot_size;
+
+        next_ = header_->write_seq.load(std::memory_order_acquire);
+        if (from_start) {
+            next_ = next_ > header_->slot_count ? next_ - header_->slot_count : 0;
+        }
+    }
+
+    ~RingReader() {
+        if (base_ && base_ != MAP_FAILED) {
+            ::munmap(base_, size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    RingReader(const RingReader&) = delete;
+    RingReader& operator=(const RingReader&) = delete;
+
+    // (stream, function) 구독, -1 = 전체 (구독이 없으면 모든 레코드)
+    void subscribe(int stream, int function) {
+        for (int s = 0; s < 128; ++s) {
+            for (int f = 0; f < 256; ++f) {
+                if ((stream < 0 || stream == s) && (function < 0 || function == f)) {
+                    filter_.set(s * 256 + f);
+                }
+            }
+        }
+    }
+
+    // 구독 레코드 1건을 슬롯에서 바로 읽어 fn(const Record&) 호출 (복사 없음)
+    // fn 실행 중 덮어써졌으면 Overrun을 반환하므로 fn은 반환값 확인 전까지 결과를 확정하지 않는다.
+    template<typename Fn>
+    ReadStatus read(Fn&& fn) {
+        while (true) {
+            uint64_t w = header_->write_seq.load(std::memory_order_acquire);
+            if (next_ >= w) {
+                if (replaced()) {
+                    return ReadStatus::Replaced;  // 남은 레코드를 다 읽은 뒤에 알린다
+                }
+                if (next_ > w) {
+                    next_ = w;  // 생산자가 ring을 새로 만듦
+                }
+                return ReadStatus::Empty;
+            }
+
+            const Slot* slot = detail::slot_at(base_, slot_size_, next_ & mask_);
+            uint64_t expected = 2 * next_ + 2;
+            uint64_t s1 = slot->stamp.load(std::memory_order_acquire);
+            if (s1 != expected) {
+                if (s1 > expected) {
+                    return overrun(w);
+                }
+                return ReadStatus::Empty;
+            }
+
+            const Record& rec = slot->record;
+            bool wanted = filter_.none() || filter_.test((rec.stream & 0x7F) * 256 + rec.function);
+            if (wanted) {
+                fn(rec);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->stamp.load(std::memory_order_relaxed) != s1) {
+                return overrun(header_->write_seq.load(std::memory_order_acquire));
+            }
+            ++next_;
+            if (wanted) {
+                return ReadStatus::Ok;
+            }
+        }
+    }
+
+    // 구독 레코드를 out에 복사 (payload 제외, 슬롯이 재사용돼도 안전)
+    ReadStatus read_copy(Record& out) {
+        return read([&out](const Record& r) { std::memcpy(&out, &r, sizeof(Record)); });
+    }
+
+    uint64_t next_seq() const { return next_; }
+    uint64_t lost() const { return lost_; }
+    uint64_t backlog() const { return header_->write_seq.load(std::memory_order_acquire) - next_; }
+    uint32_t slot_count() const { return header_->slot_count; }
+    bool replaced() const { return header_->replaced.load(std::memory_order_acquire) != 0; }
+
+    // 밀린 레코드를 버리고 최신 위치로 이동
+    void seek_latest() {
+        next_ = header_->write_seq.load(std::memory_order_acquire);
+    }
+
+private:
+    // ring 절반 뒤로 건너뛰어 곧바로 다시 추월당하지 않게 한다
+    ReadStatus overrun(uint64_t w) {
+        uint64_t half = (mask_ + 1) / 2;
+        uint64_t target = w > half ? w - half : 0;
+        if (target <= next_) {
+            target = next_ + 1;
+        }
+        lost_ += target - next_;
+        next_ = target;
+        return ReadStatus::Overrun;
+    }
+
+private:
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    const RingHeader* header_ = nullptr;
+    uint64_t mask_ = 0;
+    uint32_t slot_size_ = 0;
+    uint64_t next_ = 0;
+    uint64_t lost_ = 0;
+    std::bitset<128 * 256> filter_;
+};
+
+} // namespace secs::shm
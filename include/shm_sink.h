@@ -0,0 +1,139 @@
+#pragma once
+
+#include "config.h"
+#include "message.h"
+#include "sink.h"
+#include "shm_ring.h"
+#include <spdlog/spdlog.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// 프로세스당 하나의 ring 생산자 (워커 / 코어 sink가 공유, 배치 단위로 직렬화)
+class ShmPublisher {
+public:
+    explicit ShmPublisher(const Config& cfg)
+        : writer_(cfg.shm_ring_name,
+                  static_cast<uint32_t>(cfg.shm_ring_slots),
+                  static_cast<uint32_t>(cfg.shm_ring_slot_size),
+                  static_cast<mode_t>(cfg.shm_ring_mode))
+    {
+        spdlog::info("공유 메모리 ring 발행: {} (slots={}, slot_size={}B, payload<={}B, mode={:04o})",
+                     cfg.shm_ring_name, cfg.shm_ring_slots, cfg.shm_ring_slot_size,
+                     writer_.payload_capacity(), cfg.shm_ring_mode);
+    }
+
+    static std::shared_ptr<ShmPublisher> shared(const Config& cfg) {
+        static std::mutex mutex;
+        static std::weak_ptr<ShmPublisher> instance;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto publisher = instance.lock();
+        if (!publisher) {
+            publisher = std::make_shared<ShmPublisher>(cfg);
+            instance = publisher;
+        }
+        return publisher;
+    }
+
+    // 파싱된 메시지만 발행, 발행 건수 / 바이트 반환
+    std::pair<size_t, uint64_t> publish(const MessageBatch& batch) {
+        // S6F11 data_items 직렬화는 잠금 밖에서
+        std::vector<std::string> payloads(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (auto s6f11 = std::dynamic_pointer_cast<S6F11Message>(batch.parsed_messages[i])) {
+                payloads[i] = s6f11->data_items.dump();
+            }
+        }
+
+        size_t published = 0;
+        uint64_t bytes = 0;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const auto& parsed = batch.parsed_messages[i];
+            if (!parsed) {
+                continue;
+            }
+            shm::Record& rec = writer_.begin();
+            fill(rec, batch.raw_messages[i], *parsed);
+
+            const std::string& payload = payloads[i];
+            size_t n = std::min(payload.size(), writer_.payload_capacity());
+            std::memcpy(writer_.payload(rec), payload.data(), n);
+            rec.payload_len = static_cast<uint16_t>(n);
+            rec.truncated = n < payload.size();
+
+            writer_.commit();
+            ++published;
+            bytes += sizeof(shm::Record) + n;
+        }
+        return {published, bytes};
+    }
+
+private:
+    static void fill(shm::Record& rec, const RawMessage& raw, const ParsedMessage& parsed) {
+        rec.recv_ns = raw.recv_ns;
+        rec.device_id = parsed.device_id;
+        rec.stream = static_cast<uint8_t>(parsed.stream);
+        rec.function = static_cast<uint8_t>(parsed.function);
+        rec.wbit = parsed.wbit;
+        shm::set_field(rec.system_bytes, parsed.system_bytes);
+        shm::set_field(rec.timestamp, parsed.timestamp);
+
+        if (auto* m = dynamic_cast<const S2F49Message*>(&parsed)) {
+            rec.kind = shm::kS2F49;
+            auto& f = rec.s2f49;
+            f.txn_code = m->txn_code;
+            f.priority = m->priority;
+            shm::set_field(f.txn_id, m->txn_id);
+            shm::set_field(f.command_type, m->command_type);
+            shm::set_field(f.command_id, m->command_id);
+            shm::set_field(f.carrier_id, m->carrier_id);
+            shm::set_field(f.source, m->source);
+            shm::set_field(f.dest, m->dest);
+            shm::set_field(f.source_type, m->source_type);
+            shm::set_field(f.dest_type, m->dest_type);
+        }
+        else if (auto* m = dynamic_cast<const S6F11Message*>(&parsed)) {
+            rec.kind = shm::kS6F11;
+            rec.s6f11.event_report_id = m->event_report_id;
+            rec.s6f11.event_id = m->event_id;
+        }
+        else {
+            rec.kind = shm::kOther;
+        }
+    }
+
+private:
+    shm::RingWriter writer_;
+    std::mutex mutex_;
+};
+
+// 공유 메모리 ring sink (로컬 소비자용, DB 폴링 대체)
+class ShmSink : public Sink {
+public:
+    explicit ShmSink(const Config& cfg)
+        : publisher_(ShmPublisher::shared(cfg))
+    {}
+
+    const char* name() const override { return "shm"; }
+
+    void write_batch(const MessageBatch& batch) override {
+        auto [published, bytes] = publisher_->publish(batch);
+        total_written_ += published;
+        bytes_written_ += bytes;
+    }
+
+    uint64_t total_written() const override { return total_written_; }
+    uint64_t bytes_written() const override { return bytes_written_; }
+
+private:
+    std::shared_ptr<ShmPublisher> publisher_;
+    uint64_t total_written_ = 0;
+    uint64_t bytes_written_ = 0;
+};
+
+} // namespace secs
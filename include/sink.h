@@ -0,0 +1,47 @@
+#pragma once
+
+#include "message.h"
+#include <cstdint>
+
+namespace secs {
+
+// 배치 출력 대상 (PostgreSQL, 컬럼 파일 등)
+// 워커마다 자체 인스턴스를 소유하므로 구현은 스레드 안전할 필요가 없다.
+class Sink {
+public:
+    virtual ~Sink() = default;
+
+    virtual const char* name() const = 0;
+
+    // 배치 기록 (실패 시 예외)
+    virtual void write_batch(const MessageBatch& batch) = 0;
+
+    // 버퍼링된 데이터 강제 기록 (워커 종료 시 호출)
+    virtual void flush() {}
+
+    virtual uint64_t total_written() const = 0;
+
+    // write_batch 반환 시 저장소 커밋까지 끝났는지 (false = 비동기 기록,
+    // 상태 캐시 committed 반영은 sink 쪽에서 커밋 후 수행)
+    virtual bool commits_on_write() const { return true; }
+
+    // 저장소로 보낸 바이트 (근사치)
+    virtual uint64_t bytes_written() const { return 0; }
+};
+
+// 아무것도 저장하지 않는 sink (DB 없이 수신/파싱 처리량 측정용)
+class NullSink : public Sink {
+public:
+    const char* name() const override { return "null"; }
+
+    void write_batch(const MessageBatch& batch) override {
+        total_written_ += batch.size();
+    }
+
+    uint64_t total_written() const override { return total_written_; }
+
+private:
+    uint64_t total_written_ = 0;
+};
+
+} // namespace secs
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "config.h"
+#include "sink.h"
+#include "db_writer.h"
+#include "sharded_db_writer.h"
+#include "arrow_sink.h"
+#include "shm_sink.h"
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// SINKS 설정 ("postgres,arrow" 등)에 따라 워커 전용 sink 목록 생성
+inline std::vector<std::unique_ptr<Sink>> make_sinks(const Config& cfg, [[maybe_unused]] size_t worker_id) {
+    std::vector<std::unique_ptr<Sink>> sinks;
+
+    std::istringstream iss(cfg.sinks);
+    std::string name;
+    while (std::getline(iss, name, ',')) {
+        if (name == "postgres") {
+            // DB_TARGETS 설정 시 deviceId 샤딩 (writer는 프로세스 공유)
+            if (!cfg.db_targets.empty()) {
+                sinks.push_back(std::make_unique<ShardedDbSink>(cfg));
+            } else {
+                sinks.push_back(std::make_unique<DatabaseWriter>(cfg));
+            }
+        }
+        else if (name == "arrow") {
+#ifdef SECS_HAVE_ARROW
+            sinks.push_back(std::make_unique<ArrowIpcSink>(cfg, worker_id));
+#else
+            throw std::runtime_error("arrow sink 미포함 빌드 (Apache Arrow 없음)");
+#endif
+        }
+        else if (name == "shm") {
+            sinks.push_back(std::make_unique<ShmSink>(cfg));
+        }
+        else if (name == "null") {
+            sinks.push_back(std::make_unique<NullSink>());
+        }
+        else if (!name.empty()) {
+            throw std::invalid_argument("알 수 없는 sink: " + name);
+        }
+    }
+
+    if (sinks.empty()) {
+        throw std::invalid_argument("SINKS 설정이 비어 있음");
+    }
+    return sinks;
+}
+
+} // namespace secs
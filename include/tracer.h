@@ -0,0 +1,279 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace secs {
+
+// 배치 타임라인 추적 (opt-in)
+//
+// 스레드마다 고정 크기 ring buffer에 begin/end 이벤트를 기록하고,
+// 요청 시 Chrome trace / Perfetto JSON(traceEvents)으로 내보낸다.
+// - 기록: 스레드 전용 ring, 슬롯마다 seqlock (락 없음)
+// - 비활성: enabled() 분기 1회 (atomic relaxed load)
+// - ring이 가득 차면 가장 오래된 이벤트부터 덮어씀 (최근 구간만 유지)
+// 이벤트 이름은 문자열 리터럴만 사용한다 (포인터만 저장).
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    static bool enabled() {
+        return enabled_flag().load(std::memory_order_relaxed);
+    }
+
+    // ring 크기는 처음 활성화 이후 생성되는 ring부터 적용 (2의 거듭제곱으로 올림)
+    void configure(size_t events_per_thread) {
+        size_t cap = 1;
+        while (cap < events_per_thread) {
+            cap <<= 1;
+        }
+        capacity_.store(cap, std::memory_order_relaxed);
+    }
+
+    void set_enabled(bool on) {
+        enabled_flag().store(on, std::memory_order_relaxed);
+        spdlog::info("추적 {}", on ? "활성화" : "비활성화");
+    }
+
+    // 현재 스레드 이름 (trace 뷰어 표시용, 스레드 시작 시 호출)
+    static void set_thread_name(std::string name) {
+        thread_name() = std::move(name);
+    }
+
+    static void begin(const char* name, uint64_t arg = 0) {
+        if (enabled()) {
+            instance().record('B', name, now_ns(), arg);
+        }
+    }
+
+    static void end(const char* name, uint64_t arg = 0) {
+        if (enabled()) {
+            instance().record('E', name, now_ns(), arg);
+        }
+    }
+
+    // 다른 시점에 시작되어 지금 끝나는 구간 (예: RawMessage 수신 시각 → dequeue의 큐 대기)
+    // 스레드 구간과 겹칠 수 있으므로 async 이벤트로 기록 (id = 시작 시각)
+    static void span_since(const char* name, uint64_t begin_ns) {
+        if (enabled() && begin_ns != 0) {
+            auto& t = instance();
+            t.record('b', name, begin_ns, begin_ns);
+            t.record('e', name, now_ns(), begin_ns);
+        }
+    }
+
+    static void instant(const char* name, uint64_t arg = 0) {
+        if (enabled()) {
+            instance().record('i', name, now_ns(), arg);
+        }
+    }
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // 모든 스레드 ring을 Chrome trace JSON 파일로 저장, 이벤트 수 반환
+    size_t dump(const std::string& path) const {
+        nlohmann::json events = nlohmann::json::array();
+
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings = rings_;
+        }
+
+        for (const auto& ring : rings) {
+            events.push_back({
+                {"ph", "M"}, {"name", "thread_name"}, {"pid", 1}, {"tid", ring->tid},
+                {"args", {{"name", ring->name}}}
+            });
+            ring->collect(ring->tid, events);
+        }
+
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("trace 파일 열기 실패: " + path);
+        }
+        out << nlohmann::json{{"traceEvents", events}, {"displayTimeUnit", "ms"}}.dump();
+
+        size_t count = events.size() - rings.size();
+        spdlog::info("trace 저장: {} ({}건, {} threads)", path, count, rings.size());
+        return count;
+    }
+
+private:
+    friend class TraceScope;
+
+    // seq: 2i+1 = 이벤트 i 기록 중, 2i+2 = 이벤트 i 기록 완료 (0 = 빈 슬롯)
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        std::atomic<uint64_t> ts{0};
+        std::atomic<uint64_t> arg{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<char> phase{0};
+    };
+
+    // 단일 writer (소유 스레드) / 다중 reader (dump)
+    struct Ring {
+        Ring(size_t cap, int id, std::string thread)
+            : slots(cap), mask(cap - 1), tid(id), name(std::move(thread)) {}
+
+        void push(char ph, const char* ev, uint64_t ts_ns, uint64_t a) {
+            uint64_t h = head.load(std::memory_order_relaxed);
+            Slot& s = slots[h & mask];
+            s.seq.store(2 * h + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);  // 홀수 seq가 데이터보다 먼저 보이도록
+            s.ts.store(ts_ns, std::memory_order_relaxed);
+            s.arg.store(a, std::memory_order_relaxed);
+            s.name.store(ev, std::memory_order_relaxed);
+            s.phase.store(ph, std::memory_order_relaxed);
+            s.seq.store(2 * h + 2, std::memory_order_release);
+            head.store(h + 1, std::memory_order_release);
+        }
+
+        // 복사 전후 seq가 같고 기대한 이벤트 번호인 슬롯만 사용 (기록 중 / 덮어쓴 슬롯은 버린다)
+        void collect(int thread_id, nlohmann::json& out) const {
+            uint64_t h = head.load(std::memory_order_acquire);
+            uint64_t first = h > slots.size() ? h - slots.size() : 0;
+
+            struct Copy { uint64_t ts, arg; const char* name; char ph; };
+            std::vector<Copy> copies;
+            copies.reserve(h - first);
+            for (uint64_t i = first; i < h; ++i) {
+                const Slot& s = slots[i & mask];
+                uint64_t seq = s.seq.load(std::memory_order_acquire);
+                if (seq != 2 * i + 2) {
+                    continue;
+                }
+                Copy c{s.ts.load(std::memory_order_relaxed),
+                       s.arg.load(std::memory_order_relaxed),
+                       s.name.load(std::memory_order_relaxed),
+                       s.phase.load(std::memory_order_relaxed)};
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (s.seq.load(std::memory_order_relaxed) == seq) {
+                    copies.push_back(c);
+                }
+            }
+
+            for (const auto& c : copies) {
+                if (!c.name) {
+                    continue;
+                }
+                nlohmann::json ev = {
+                    {"ph", std::string(1, c.ph)}, {"name", c.name}, {"pid", 1}, {"tid", thread_id},
+                    {"ts", static_cast<double>(c.ts) / 1000.0}
+                };
+                if (c.ph == 'b' || c.ph == 'e') {
+                    ev["cat"] = "async";
+                    ev["id"] = c.arg;
+                }
+                else if (c.arg != 0) {
+                    ev["args"] = {{"n", c.arg}};
+                }
+                if (c.ph == 'i') {
+                    ev["s"] = "t";
+                }
+                out.push_back(std::move(ev));
+            }
+        }
+
+        std::vector<Slot> slots;
+        size_t mask;
+        std::atomic<uint64_t> head{0};
+        std::atomic<bool> alive{true};  // 소유 스레드 종료 시 false
+        int tid;
+        std::string name;
+    };
+
+    Tracer() : capacity_(1 << 16) {}
+
+    static std::atomic<bool>& enabled_flag() {
+        static std::atomic<bool> flag{false};
+        return flag;
+    }
+
+    static std::string& thread_name() {
+        thread_local std::string name;
+        return name;
+    }
+
+    // 스레드 종료 시 ring을 종료 상태로 표시
+    struct RingOwner {
+        std::shared_ptr<Ring> ring;
+
+        ~RingOwner() {
+            if (ring) {
+                ring->alive.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    void record(char ph, const char* name, uint64_t ts_ns, uint64_t arg) {
+        thread_local RingOwner owner;
+        if (!owner.ring) {
+            owner.ring = register_thread();
+        }
+        owner.ring->push(ph, name, ts_ns, arg);
+    }
+
+    // 스레드별 최초 기록 시 1회
+    // 종료된 스레드의 ring은 이때 제거한다 (워커 재시작 / 리사이즈로 ring이 계속 쌓이지 않도록)
+    std::shared_ptr<Ring> register_thread() {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                    [](const auto& r) { return !r->alive.load(std::memory_order_acquire); }),
+                     rings_.end());
+        int tid = ++next_tid_;
+        std::string name = thread_name().empty() ? "thread-" + std::to_string(tid) : thread_name();
+        auto ring = std::make_shared<Ring>(capacity_.load(std::memory_order_relaxed), tid, name);
+        rings_.push_back(ring);
+        return ring;
+    }
+
+private:
+    std::atomic<size_t> capacity_;
+    mutable std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    int next_tid_ = 0;  // trace 뷰어 tid (제거된 ring과 겹치지 않도록 계속 증가)
+};
+
+// 구간 begin/end (스코프 종료 시 end 기록)
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, uint64_t arg = 0)
+        : name_(Tracer::enabled() ? name : nullptr)
+    {
+        if (name_) {
+            Tracer::begin(name_, arg);
+        }
+    }
+
+    // 도중에 비활성화되어도 begin과 짝을 맞춘다
+    ~TraceScope() {
+        if (name_) {
+            Tracer::instance().record('E', name_, Tracer::now_ns(), 0);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name_;
+};
+
+} // namespace secs
@@ -2,28 +2,37 @@
 
 #include "config.h"
 #include "message.h"
-#include "bounded_queue.h"
+#include "ingress.h"
+#include "receiver.h"
+#include "tracer.h"
 #include <boost/asio.hpp>
 #include <spdlog/spdlog.h>
+#include <sys/socket.h>
 #include <atomic>
 #include <array>
+#include <cerrno>
+#include <cstring>
 
 namespace secs {
 
 using boost::asio::ip::udp;
 
-class UdpReceiver {
+class UdpReceiver : public Receiver {
 public:
-    UdpReceiver(const Config& cfg, BoundedQueue<RawMessage>& queue)
+    // wakeup 1회당 최대 recvmsg 횟수 (다른 핸들러 기아 방지)
+    static constexpr int kMaxDrainPerWakeup = 64;
+
+    UdpReceiver(const Config& cfg, Ingress& ingress)
         : config_(cfg)
-        , queue_(queue)
+        , ingress_(ingress)
         , socket_(io_context_)
         , running_(false)
         , total_received_(0)
         , total_bytes_(0)
+        , total_syscalls_(0)
     {}
 
-    void start() {
+    void start() override {
         // UDP 소켓 바인딩
         udp::endpoint endpoint(
             boost::asio::ip::address::from_string(config_.udp_host),
@@ -37,16 +46,24 @@ public:
         boost::asio::socket_base::receive_buffer_size option(25 * 1024 * 1024);
         socket_.set_option(option);
         
+        // 커널 버퍼 드롭 카운터 + 논블로킹 recvmsg
+        Ingress::enable_kernel_drop_counter(socket_.native_handle());
+        socket_.non_blocking(true);
+        ingress_.attach_socket(socket_.native_handle());
+        
         spdlog::info("UDP 수신 시작: {}:{}", config_.udp_host, config_.udp_port);
         
         running_ = true;
+        cpu_clock_.attach();
+        Tracer::set_thread_name("recv-asio");
         start_receive();
         
         // io_context 실행 (블로킹)
         io_context_.run();
+        cpu_clock_.detach();
     }
 
-    void stop() {
+    void stop() override {
         if (!running_) return;
     
         running_ = false;
@@ -62,31 +79,64 @@ public:
         io_context_.stop();
     }
 
-    uint64_t total_received() const { return total_received_.load(); }
-    uint64_t total_bytes() const { return total_bytes_.load(); }
+    const char* backend_name() const override { return "asio"; }
+
+    uint64_t total_received() const override { return total_received_.load(); }
+    uint64_t total_bytes() const override { return total_bytes_.load(); }
+    
+    // recvmsg 호출 수 (EAGAIN 포함, epoll_wait 제외)
+    uint64_t total_syscalls() const override { return total_syscalls_.load(); }
+    uint64_t cpu_time_ns() const override { return cpu_clock_.elapsed_ns(); }
 
 private:
+    // readable 대기 후 소켓 버퍼를 직접 비운다 (cmsg로 SO_RXQ_OVFL 수신)
     void start_receive() {
-        socket_.async_receive_from(
-            boost::asio::buffer(recv_buffer_),
-            remote_endpoint_,
-            [this](const boost::system::error_code& ec, std::size_t bytes_recvd) {
-                handle_receive(ec, bytes_recvd);
+        socket_.async_wait(
+            udp::socket::wait_read,
+            [this](const boost::system::error_code& ec) {
+                handle_readable(ec);
             }
         );
     }
 
-    void handle_receive(const boost::system::error_code& ec, std::size_t bytes_recvd) {
+    void handle_readable(const boost::system::error_code& ec) {
         if (!ec && running_) {
-            // 통계 업데이트
-            total_received_++;
-            total_bytes_ += bytes_recvd;
-            
-            // 큐에 추가 (논블로킹)
-            RawMessage msg(recv_buffer_.data(), bytes_recvd);
-            if (!queue_.try_push(std::move(msg))) {
-                // 큐 오버플로우 → 메시지 드롭
-                spdlog::warn("큐 오버플로우 - 메시지 드롭 (qsize={})", queue_.size());
+            TraceScope trace("recv");
+            int fd = socket_.native_handle();
+            for (int i = 0; i < kMaxDrainPerWakeup; ++i) {
+                iovec iov{recv_buffer_.data(), recv_buffer_.size()};
+                msghdr msg{};
+                msg.msg_name = remote_endpoint_.data();
+                msg.msg_namelen = static_cast<socklen_t>(remote_endpoint_.capacity());
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+                msg.msg_control = control_buffer_.data();
+                msg.msg_controllen = control_buffer_.size();
+
+                ssize_t n = ::recvmsg(fd, &msg, MSG_DONTWAIT);
+                total_syscalls_++;
+                if (n < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                        spdlog::error("UDP 수신 오류: {}", std::strerror(errno));
+                    }
+                    break;
+                }
+                remote_endpoint_.resize(msg.msg_namelen);
+
+                for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+                    if (auto counter = Ingress::kernel_drop_counter(c)) {
+                        ingress_.on_kernel_drop_counter(*counter, last_drop_counter_);
+                    }
+                }
+
+                // 통계 업데이트
+                total_received_++;
+                total_bytes_ += static_cast<size_t>(n);
+                
+                // 큐에 추가 (논블로킹, 가득 차면 드롭)
+                const auto* source = msg.msg_namelen >= sizeof(sockaddr_in)
+                    ? reinterpret_cast<const sockaddr_in*>(remote_endpoint_.data()) : nullptr;
+                ingress_.deliver(recv_buffer_.data(), static_cast<size_t>(n), source);
             }
             
             // 다음 수신 대기
@@ -100,16 +150,20 @@ private:
 
 private:
     const Config& config_;
-    BoundedQueue<RawMessage>& queue_;
+    Ingress& ingress_;
     
     boost::asio::io_context io_context_;
     udp::socket socket_;
     udp::endpoint remote_endpoint_;
     std::array<uint8_t, 65536> recv_buffer_;  // 64KB 버퍼
+    alignas(cmsghdr) std::array<uint8_t, Ingress::kControlLen> control_buffer_;
+    uint32_t last_drop_counter_ = 0;
     
     std::atomic<bool> running_;
     std::atomic<uint64_t> total_received_;
     std::atomic<uint64_t> total_bytes_;
+    std::atomic<uint64_t> total_syscalls_;
+    ThreadCpuClock cpu_clock_;
 };
 
 } // namespace secs
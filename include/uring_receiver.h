@@ -0,0 +1,330 @@
+#pragma once
+
+#ifdef SECS_HAVE_IO_URING
+
+#include "config.h"
+#include "message.h"
+#include "ingress.h"
+#include "receiver.h"
+#include "tracer.h"
+#include <liburing.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <sys/utsname.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+namespace secs {
+
+// io_uring 수신 엔진
+// - multishot recvmsg: 한 번 등록한 SQE가 패킷마다 CQE를 계속 생성 (재등록 불필요)
+// - provided buffer ring: 커널이 미리 등록된 버퍼를 직접 골라 채움
+// - io_uring_enter 1회로 여러 CQE를 한꺼번에 수확
+class UringReceiver : public Receiver {
+public:
+    static constexpr int kBufferGroup = 0;
+    // UDP(IPv4) 최대 payload - asio 엔진(64KB 버퍼)이 받는 크기
+    static constexpr size_t kMaxDatagram = 65507;
+    // provided buffer 앞부분에 커널이 채우는 recvmsg_out + 송신 주소 + cmsg(SO_RXQ_OVFL)
+    static constexpr size_t kRecvmsgOverhead =
+        sizeof(io_uring_recvmsg_out) + sizeof(sockaddr_in) + Ingress::kControlLen;
+
+    UringReceiver(const Config& cfg, Ingress& ingress)
+        : config_(cfg)
+        , ingress_(ingress)
+        , running_(false)
+        , total_received_(0)
+        , total_bytes_(0)
+        , total_syscalls_(0)
+        , total_truncated_(0)
+    {}
+
+    ~UringReceiver() override {
+        cleanup();
+    }
+
+    // 커널/라이브러리가 multishot recvmsg + buffer ring을 지원하는지 확인
+    static bool supported() {
+        // multishot recvmsg는 Linux 6.0 이상
+        utsname uts{};
+        if (uname(&uts) != 0) {
+            return false;
+        }
+        int major = 0, minor = 0;
+        if (std::sscanf(uts.release, "%d.%d", &major, &minor) != 2 || major < 6) {
+            return false;
+        }
+
+        io_uring ring{};
+        if (io_uring_queue_init(4, &ring, 0) != 0) {
+            return false;
+        }
+
+        int ret = 0;
+        io_uring_buf_ring* br = io_uring_setup_buf_ring(&ring, 2, kBufferGroup, 0, &ret);
+        bool ok = (br != nullptr);
+        if (br) {
+            io_uring_free_buf_ring(&ring, br, 2, kBufferGroup);
+        }
+        io_uring_queue_exit(&ring);
+        return ok;
+    }
+
+    void start() override {
+        open_socket();
+        setup_ring();
+
+        spdlog::info("UDP 수신 시작 (io_uring): {}:{} (bufs={}x{}B)",
+                     config_.udp_host, config_.udp_port,
+                     config_.uring_buf_count, config_.uring_buf_size);
+
+        running_ = true;
+        cpu_clock_.attach();
+        Tracer::set_thread_name("recv-io_uring");
+        arm_recv();
+
+        while (running_) {
+            __kernel_timespec ts{};
+            ts.tv_nsec = 100 * 1000 * 1000;  // stop() 확인 주기 100ms
+
+            io_uring_cqe* cqe = nullptr;
+            int ret = io_uring_submit_and_wait_timeout(&ring_, &cqe, 1, &ts, nullptr);
+            total_syscalls_++;
+
+            if (ret < 0 && ret != -ETIME && ret != -EINTR) {
+                spdlog::error("io_uring 대기 오류: {}", std::strerror(-ret));
+                break;
+            }
+
+            harvest();
+        }
+
+        cpu_clock_.detach();
+        cleanup();
+    }
+
+    void stop() override {
+        // 수신 루프가 타임아웃마다 running_을 확인하므로 플래그만 내린다
+        running_ = false;
+    }
+
+    const char* backend_name() const override { return "io_uring"; }
+
+    uint64_t total_received() const override { return total_received_.load(); }
+    uint64_t total_bytes() const override { return total_bytes_.load(); }
+    uint64_t total_syscalls() const override { return total_syscalls_.load(); }
+    uint64_t cpu_time_ns() const override { return cpu_clock_.elapsed_ns(); }
+    uint64_t total_truncated() const override { return total_truncated_.load(); }
+
+private:
+    void open_socket() {
+        fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) {
+            throw std::runtime_error(std::string("socket() 실패: ") + std::strerror(errno));
+        }
+
+        int rcvbuf = 25 * 1024 * 1024;
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        Ingress::enable_kernel_drop_counter(fd_);
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(config_.udp_port);
+        if (::inet_pton(AF_INET, config_.udp_host.c_str(), &addr.sin_addr) != 1) {
+            throw std::runtime_error("잘못된 UDP_HOST: " + config_.udp_host);
+        }
+        if (::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            throw std::runtime_error(std::string("bind() 실패: ") + std::strerror(errno));
+        }
+        ingress_.attach_socket(fd_);
+    }
+
+    void setup_ring() {
+        int ret = io_uring_queue_init(static_cast<unsigned>(config_.uring_entries), &ring_, 0);
+        if (ret != 0) {
+            throw std::runtime_error(std::string("io_uring_queue_init 실패: ") + std::strerror(-ret));
+        }
+        ring_ready_ = true;
+
+        buf_count_ = static_cast<unsigned>(config_.uring_buf_count);
+        if (buf_count_ == 0 || (buf_count_ & (buf_count_ - 1)) != 0 || buf_count_ > 32768) {
+            throw std::runtime_error("URING_BUF_COUNT는 32768 이하의 2의 거듭제곱이어야 함");
+        }
+        // URING_BUF_SIZE = 수신할 최대 데이터그램 크기 (헤더 공간은 버퍼마다 더한다, 64B 정렬)
+        if (config_.uring_buf_size < kMaxDatagram) {
+            spdlog::warn("URING_BUF_SIZE({}) 초과 데이터그램은 잘려서 버려짐 (asio는 {}B까지 수신)",
+                         config_.uring_buf_size, kMaxDatagram);
+        }
+        buf_size_ = static_cast<unsigned>((config_.uring_buf_size + kRecvmsgOverhead + 63) & ~size_t(63));
+
+        buf_ring_ = io_uring_setup_buf_ring(&ring_, buf_count_, kBufferGroup, 0, &ret);
+        if (!buf_ring_) {
+            throw std::runtime_error(std::string("buffer ring 등록 실패: ") + std::strerror(-ret));
+        }
+
+        buffers_ = static_cast<uint8_t*>(std::aligned_alloc(4096, size_t(buf_count_) * buf_size_));
+        if (!buffers_) {
+            throw std::bad_alloc();
+        }
+
+        int mask = io_uring_buf_ring_mask(buf_count_);
+        for (unsigned i = 0; i < buf_count_; ++i) {
+            io_uring_buf_ring_add(buf_ring_, buffer_at(i), buf_size_, i, mask, i);
+        }
+        io_uring_buf_ring_advance(buf_ring_, buf_count_);
+
+        // multishot recvmsg 템플릿: 버퍼 앞부분에 recvmsg_out + 주소 + cmsg(SO_RXQ_OVFL)가 채워진다
+        std::memset(&msg_template_, 0, sizeof(msg_template_));
+        msg_template_.msg_namelen = sizeof(sockaddr_in);
+        msg_template_.msg_controllen = Ingress::kControlLen;
+    }
+
+    void arm_recv() {
+        io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+        if (!sqe) {
+            io_uring_submit(&ring_);
+            total_syscalls_++;
+            sqe = io_uring_get_sqe(&ring_);
+        }
+        io_uring_prep_recvmsg_multishot(sqe, fd_, &msg_template_, 0);
+        sqe->flags |= IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+    }
+
+    // 완료 큐에 쌓인 CQE를 모두 처리하고 사용한 버퍼를 ring에 반납
+    void harvest() {
+        TraceScope trace(io_uring_cq_ready(&ring_) > 0 ? "recv" : nullptr);
+        unsigned head;
+        unsigned count = 0;
+        int returned = 0;
+        bool rearm = false;
+        int mask = io_uring_buf_ring_mask(buf_count_);
+        io_uring_cqe* cqe;
+
+        io_uring_for_each_cqe(&ring_, head, cqe) {
+            ++count;
+
+            if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                // multishot 종료 (ENOBUFS 등) → 재등록 필요
+                rearm = true;
+            }
+
+            if (cqe->res < 0) {
+                if (cqe->res != -ENOBUFS && cqe->res != -ECANCELED) {
+                    spdlog::error("UDP 수신 오류 (io_uring): {}", std::strerror(-cqe->res));
+                }
+                continue;
+            }
+
+            if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+                continue;
+            }
+
+            unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+            uint8_t* buf = buffer_at(bid);
+            handle_datagram(buf, cqe->res);
+
+            io_uring_buf_ring_add(buf_ring_, buf, buf_size_, bid, mask, returned++);
+        }
+
+        if (returned > 0) {
+            io_uring_buf_ring_advance(buf_ring_, returned);
+        }
+        io_uring_cq_advance(&ring_, count);
+
+        if (rearm && running_) {
+            arm_recv();
+        }
+    }
+
+    void handle_datagram(uint8_t* buf, int len) {
+        io_uring_recvmsg_out* out = io_uring_recvmsg_validate(buf, len, &msg_template_);
+        if (!out) {
+            return;
+        }
+        if (out->flags & MSG_TRUNC) {
+            // URING_BUF_SIZE보다 큰 데이터그램 (경고는 1000건마다)
+            uint64_t n = total_truncated_.fetch_add(1, std::memory_order_relaxed);
+            if (n % 1000 == 0) {
+                spdlog::warn("데이터그램 잘림 - URING_BUF_SIZE({}) 증가 필요 (누적 {}건)",
+                             config_.uring_buf_size, n + 1);
+            }
+            return;
+        }
+
+        auto* payload = static_cast<const uint8_t*>(io_uring_recvmsg_payload(out, &msg_template_));
+        unsigned payload_len = io_uring_recvmsg_payload_length(out, len, &msg_template_);
+
+        for (cmsghdr* c = io_uring_recvmsg_cmsg_firsthdr(out, &msg_template_); c;
+             c = io_uring_recvmsg_cmsg_nexthdr(out, &msg_template_, c)) {
+            if (auto counter = Ingress::kernel_drop_counter(c)) {
+                ingress_.on_kernel_drop_counter(*counter, last_drop_counter_);
+            }
+        }
+
+        total_received_++;
+        total_bytes_ += payload_len;
+
+        // 송신 주소 (템플릿 msg_namelen = sockaddr_in, 버퍼 앞부분에 채워짐)
+        sockaddr_in source{};
+        if (out->namelen >= sizeof(source)) {
+            std::memcpy(&source, io_uring_recvmsg_name(out), sizeof(source));
+        }
+        ingress_.deliver(payload, payload_len, &source);
+    }
+
+    uint8_t* buffer_at(unsigned bid) const {
+        return buffers_ + size_t(bid) * buf_size_;
+    }
+
+    void cleanup() {
+        if (buf_ring_) {
+            io_uring_free_buf_ring(&ring_, buf_ring_, buf_count_, kBufferGroup);
+            buf_ring_ = nullptr;
+        }
+        if (ring_ready_) {
+            io_uring_queue_exit(&ring_);
+            ring_ready_ = false;
+        }
+        if (buffers_) {
+            std::free(buffers_);
+            buffers_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+private:
+    const Config& config_;
+    Ingress& ingress_;
+
+    int fd_ = -1;
+    io_uring ring_{};
+    bool ring_ready_ = false;
+    io_uring_buf_ring* buf_ring_ = nullptr;
+    uint8_t* buffers_ = nullptr;
+    unsigned buf_count_ = 0;
+    unsigned buf_size_ = 0;
+    msghdr msg_template_{};
+    uint32_t last_drop_counter_ = 0;
+
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> total_received_;
+    std::atomic<uint64_t> total_bytes_;
+    std::atomic<uint64_t> total_syscalls_;
+    std::atomic<uint64_t> total_truncated_;
+    ThreadCpuClock cpu_clock_;
+};
+
+} // namespace secs
+
+#endif // SECS_HAVE_IO_URING
@@ -2,12 +2,14 @@
 
 #include "config.h"
 #include "message.h"
-#include "bounded_queue.h"
-#include "parser.h"
-#include "db_writer.h"
+#include "lane_queue.h"
+#include "message_pipeline.h"
 #include <spdlog/spdlog.h>
 #include <thread>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 
@@ -15,111 +17,304 @@ namespace secs {
 
 class WorkerPool {
 public:
-    WorkerPool(const Config& cfg, BoundedQueue<RawMessage>& queue)
+    // 워커 상태 (stats 조회용)
+    enum class WorkerState : int {
+        Starting,
+        Idle,       // 큐 대기
+        Batching,   // 배치 수집 중
+        Flushing,   // DB 삽입 중
+        Exited
+    };
+
+    WorkerPool(const Config& cfg, LaneQueue& queue, const RouteTable& routes)
         : config_(cfg)
         , queue_(queue)
+        , routes_(routes)
         , running_(false)
+        , batch_size_(cfg.batch_size)
+        , batch_timeout_ms_(cfg.batch_timeout_ms)
+        , next_worker_id_(0)
     {}
 
     void start() {
         running_ = true;
-        
+
         // Worker 스레드 생성
+        std::lock_guard<std::mutex> lock(slots_mutex_);
         for (size_t i = 0; i < config_.worker_count; ++i) {
-            workers_.emplace_back([this, i]() {
-                worker_main(i);
-            });
+            spawn_worker();
         }
-        
+
         spdlog::info("Worker Pool 시작: {} workers", config_.worker_count);
     }
 
     void stop() {
         running_ = false;
-        
+
         // 모든 워커 종료 대기
-        for (auto& worker : workers_) {
-            if (worker.joinable()) {
-                worker.join();
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+        for (auto& slot : slots_) {
+            if (slot->thread.joinable()) {
+                slot->thread.join();
             }
         }
-        
+        slots_.clear();
+
         spdlog::info("Worker Pool 종료");
     }
 
+    // 런타임 워커 수 변경
+    // 축소 시 워커는 현재 배치를 DB에 반영한 뒤 종료하고, 큐의 메시지는 남은 워커가 처리한다.
+    size_t resize(size_t count) {
+        if (count == 0) {
+            count = 1;
+        }
+
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+        reap_exited();
+
+        size_t active = active_count();
+        for (size_t i = active; i < count; ++i) {
+            spawn_worker();
+        }
+        for (auto it = slots_.rbegin(); it != slots_.rend() && active > count; ++it) {
+            if (!(*it)->retire) {
+                (*it)->retire = true;
+                --active;
+            }
+        }
+
+        spdlog::info("Worker Pool 크기 변경: {} workers", count);
+        return count;
+    }
+
+    // S6F11 윈도우 집계 연결 (start() 이전)
+    void set_aggregator(EventAggregator* aggregator) { aggregator_ = aggregator; }
+
+    // 캐리어 상태 캐시 연결 (start() 이전)
+    void set_state_cache(CarrierStateCache* cache) { state_cache_ = cache; }
+
+    // S2F50 자동 응답 연결 (start() 이전)
+    void set_ack_sender(AckSender* acks) { acks_ = acks; }
+
+    void set_batch_size(size_t n) { batch_size_ = n > 0 ? n : 1; }
+    void set_batch_timeout_ms(size_t ms) { batch_timeout_ms_ = ms > 0 ? ms : 1; }
+    size_t batch_size() const { return batch_size_.load(); }
+    size_t batch_timeout_ms() const { return batch_timeout_ms_.load(); }
+
+    size_t worker_count() const {
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+        return active_count();
+    }
+
+    // 워커별 상태 스냅샷
+    json stats() const {
+        std::lock_guard<std::mutex> lock(slots_mutex_);
+
+        json workers = json::array();
+        size_t inflight_batches = 0;
+        for (const auto& slot : slots_) {
+            auto state = static_cast<WorkerState>(slot->state.load());
+            size_t inflight = slot->inflight.load();
+            if (state == WorkerState::Flushing) {
+                inflight_batches++;
+            }
+            workers.push_back({
+                {"id", slot->id},
+                {"state", state_name(state)},
+                {"retiring", slot->retire.load()},
+                {"inflight", inflight},
+                {"inserted", slot->inserted.load()},
+                {"failed_batches", slot->failed_batches.load()},
+                {"bytes_written", slot->bytes_written.load()}
+            });
+        }
+
+        return {
+            {"worker_count", active_count()},
+            {"batch_size", batch_size_.load()},
+            {"batch_timeout_ms", batch_timeout_ms_.load()},
+            {"inflight_batches", inflight_batches},
+            {"workers", workers}
+        };
+    }
+
 private:
-    void worker_main(size_t worker_id) {
+    struct WorkerSlot {
+        size_t id = 0;
+        std::thread thread;
+        std::atomic<bool> retire{false};
+        std::atomic<int> state{static_cast<int>(WorkerState::Starting)};
+        std::atomic<size_t> inflight{0};     // 현재 배치에 쌓인 메시지 수
+        std::atomic<uint64_t> inserted{0};
+        std::atomic<uint64_t> failed_batches{0};
+        std::atomic<uint64_t> bytes_written{0};  // sink 전송 바이트 합계
+    };
+
+    static const char* state_name(WorkerState s) {
+        switch (s) {
+            case WorkerState::Starting: return "starting";
+            case WorkerState::Idle:     return "idle";
+            case WorkerState::Batching: return "batching";
+            case WorkerState::Flushing: return "flushing";
+            case WorkerState::Exited:   return "exited";
+        }
+        return "unknown";
+    }
+
+    // slots_mutex_ 보유 상태에서 호출
+    void spawn_worker() {
+        auto slot = std::make_unique<WorkerSlot>();
+        slot->id = next_worker_id_++;
+        WorkerSlot* raw = slot.get();
+        slot->thread = std::thread([this, raw]() {
+            worker_main(*raw);
+        });
+        slots_.push_back(std::move(slot));
+    }
+
+    // slots_mutex_ 보유 상태에서 호출
+    void reap_exited() {
+        for (auto it = slots_.begin(); it != slots_.end();) {
+            if ((*it)->state == static_cast<int>(WorkerState::Exited)) {
+                if ((*it)->thread.joinable()) {
+                    (*it)->thread.join();
+                }
+                it = slots_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    size_t active_count() const {
+        size_t n = 0;
+        for (const auto& slot : slots_) {
+            if (!slot->retire && slot->state != static_cast<int>(WorkerState::Exited)) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    // 배치 기록 후 워커 통계 / lane별 수신 → 기록 완료 지연 갱신
+    void flush_batch(MessagePipeline& pipeline, WorkerSlot& slot) {
+        pipeline.flush([this](const MessageBatch& batch) {
+            uint64_t now = Tracer::now_ns();
+            for (const auto& raw : batch.raw_messages) {
+                if (raw.recv_ns != 0 && now > raw.recv_ns) {
+                    queue_.record_latency(raw.lane, now - raw.recv_ns);
+                }
+            }
+        });
+        slot.inserted.store(pipeline.inserted(), std::memory_order_relaxed);
+        slot.failed_batches.store(pipeline.failed_batches(), std::memory_order_relaxed);
+        slot.bytes_written.store(pipeline.bytes_written(), std::memory_order_relaxed);
+        slot.inflight.store(0, std::memory_order_relaxed);
+    }
+
+    void worker_main(WorkerSlot& slot) {
+        size_t worker_id = slot.id;
+        auto set_state = [&slot](WorkerState s) {
+            slot.state.store(static_cast<int>(s), std::memory_order_relaxed);
+        };
+
+        Tracer::set_thread_name("worker-" + std::to_string(worker_id));
+
         try {
-            // Worker별 전용 DB connection
-            DatabaseWriter db_writer(config_);
-            
-            spdlog::info("Worker #{} 시작 (전용 DB connection 할당)", worker_id);
-            
-            MessageBatch batch;
-            batch.reserve(config_.batch_size);
-            
-            auto batch_deadline = std::chrono::steady_clock::now() + 
-                                 std::chrono::milliseconds(config_.batch_timeout_ms);
-            
-            while (running_) {
+            // Worker별 전용 처리 단계 (sink: DB connection / 파일)
+            MessagePipeline pipeline(config_, "Worker #" + std::to_string(worker_id), worker_id,
+                                     routes_, aggregator_, state_cache_, acks_);
+
+            spdlog::info("Worker #{} 시작 (sinks={})", worker_id, config_.sinks);
+
+            auto batch_deadline = std::chrono::steady_clock::now() +
+                                 std::chrono::milliseconds(batch_timeout_ms_.load());
+
+            // stop() 이후에도 큐가 빌 때까지 계속 처리 (남은 메시지 유실 방지)
+            while (!slot.retire) {
+                set_state(pipeline.pending() > 0 ? WorkerState::Batching : WorkerState::Idle);
+
                 // 큐에서 메시지 수집 (timeout)
                 auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
                     batch_deadline - std::chrono::steady_clock::now()
                 );
-                
+
                 if (timeout.count() <= 0) {
                     timeout = std::chrono::milliseconds(1);
                 }
-                
+
                 auto opt_msg = queue_.pop(timeout);
-                
+
+                if (!opt_msg && !running_) {
+                    break;
+                }
+
                 if (opt_msg) {
-                    // 파싱
-                    auto parsed = MessageParser::parse(*opt_msg);
-                    
-                    // 배치에 추가
-                    batch.raw_messages.push_back(std::move(*opt_msg));
-                    batch.parsed_messages.push_back(parsed);
+                    // 수신 → dequeue 사이 큐 대기 구간
+                    Tracer::span_since("queue_wait", opt_msg->recv_ns);
+
+                    // 우선순위 lane 메시지는 배치 마감을 앞당긴다
+                    size_t lane_ms = queue_.batch_timeout_ms(opt_msg->lane);
+
+                    if (pipeline.add(std::move(*opt_msg))) {
+                        if (lane_ms) {
+                            batch_deadline = std::min(batch_deadline,
+                                std::chrono::steady_clock::now() + std::chrono::milliseconds(lane_ms));
+                        }
+                        slot.inflight.store(pipeline.pending(), std::memory_order_relaxed);
+                    }
                 }
-                
+
                 // 배치 처리 조건
-                bool batch_full = batch.size() >= config_.batch_size;
+                bool batch_full = pipeline.pending() >= batch_size_.load(std::memory_order_relaxed);
                 bool timeout_expired = std::chrono::steady_clock::now() >= batch_deadline;
-                
-                if ((batch_full || timeout_expired) && batch.size() > 0) {
-                    // DB 삽입
-                    db_writer.insert_batch(batch);
-                    
-                    spdlog::debug("Worker #{}: 배치 {}건 처리 완료", 
-                                 worker_id, batch.size());
-                    
-                    // 배치 리셋
-                    batch.clear();
-                    batch_deadline = std::chrono::steady_clock::now() + 
-                                    std::chrono::milliseconds(config_.batch_timeout_ms);
+
+                if ((batch_full || timeout_expired) && pipeline.pending() > 0) {
+                    // sink 기록 (DB 삽입 등)
+                    set_state(WorkerState::Flushing);
+                    flush_batch(pipeline, slot);
+                }
+
+                if (timeout_expired || pipeline.pending() == 0) {
+                    batch_deadline = std::chrono::steady_clock::now() +
+                                    std::chrono::milliseconds(batch_timeout_ms_.load(std::memory_order_relaxed));
                 }
             }
-            
-            // 종료 시 남은 배치 처리
-            if (batch.size() > 0) {
-                db_writer.insert_batch(batch);
-                spdlog::info("Worker #{}: 종료 전 남은 배치 {}건 처리", 
-                            worker_id, batch.size());
+
+            // 종료(또는 축소) 시 남은 배치 처리
+            if (size_t remaining = pipeline.pending()) {
+                set_state(WorkerState::Flushing);
+                flush_batch(pipeline, slot);
+                spdlog::info("Worker #{}: 종료 전 남은 배치 {}건 처리", worker_id, remaining);
             }
-            
-            spdlog::info("Worker #{} 종료 (총 {}건 삽입)", 
-                        worker_id, db_writer.total_inserted());
+
+            pipeline.finish();
         }
         catch (const std::exception& e) {
             spdlog::error("Worker #{} 오류: {}", worker_id, e.what());
         }
+
+        slot.inflight.store(0);
+        set_state(WorkerState::Exited);
     }
 
 private:
     const Config& config_;
-    BoundedQueue<RawMessage>& queue_;
+    LaneQueue& queue_;
+    const RouteTable& routes_;
+    EventAggregator* aggregator_ = nullptr;
+    CarrierStateCache* state_cache_ = nullptr;
+    AckSender* acks_ = nullptr;
     std::atomic<bool> running_;
-    std::vector<std::thread> workers_;
+
+    // 런타임 변경 가능한 배치 파라미터
+    std::atomic<size_t> batch_size_;
+    std::atomic<size_t> batch_timeout_ms_;
+
+    mutable std::mutex slots_mutex_;
+    std::vector<std::unique_ptr<WorkerSlot>> slots_;
+    size_t next_worker_id_;
 };
 
 } // namespace secs
@@ -0,0 +1,17 @@
+#!/bin/bash
+set -e
+
+# 수신 엔진 비교: 같은 offered load에서 asio / io_uring 실행
+PPS=${1:-200000}
+SECONDS_RUN=${2:-5}
+PAYLOAD=${3:-512}
+BENCH=${BENCH:-./build/recv-bench}
+
+echo "=================================================="
+echo "수신 엔진 비교 (pps=${PPS}, ${SECONDS_RUN}s, payload=${PAYLOAD}B)"
+echo "=================================================="
+
+# syscalls/packet는 커널 카운터 (권한 없으면 n/a, sudo 또는 perf_event_paranoid 조정)
+for backend in asio io_uring; do
+    UDP_PORT=${UDP_PORT:-15000} $BENCH $backend $PPS $SECONDS_RUN $PAYLOAD
+done
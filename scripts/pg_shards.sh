@@ -0,0 +1,48 @@
+#!/bin/bash
+set -e
+
+# 샤딩 테스트용 로컬 PostgreSQL 인스턴스 (docker)
+#   pg_shards.sh up [N=3] [BASE_PORT=5433]   # secs-pg-0..N-1 기동 + 스키마 적용
+#   pg_shards.sh down                        # 전부 제거
+# 기본 스키마(CREATE TABLE ...)는 SCHEMA=파일 로 지정, 그 뒤 sql/*.sql 마이그레이션을 순서대로 적용
+CMD=${1:-up}
+COUNT=${2:-3}
+BASE_PORT=${3:-5433}
+IMAGE=${PG_IMAGE:-postgres:16}
+DB_NAME=${DB_NAME:-secs_db}
+DB_USER=${DB_USER:-secs_user}
+DB_PASSWORD=${DB_PASSWORD:-secspass}
+SQL_DIR="$(cd "$(dirname "$0")/.." && pwd)/sql"
+
+if [ "$CMD" = "down" ]; then
+    docker ps -aq --filter "name=^secs-pg-" | xargs -r docker rm -f
+    exit 0
+fi
+
+echo "=================================================="
+echo "PostgreSQL 샤드 ${COUNT}개 기동 (port ${BASE_PORT}~$((BASE_PORT + COUNT - 1)))"
+echo "=================================================="
+
+targets=""
+for i in $(seq 0 $((COUNT - 1))); do
+    port=$((BASE_PORT + i))
+    docker run -d --name "secs-pg-$i" -p "$port:5432" \
+        -e POSTGRES_DB="$DB_NAME" -e POSTGRES_USER="$DB_USER" -e POSTGRES_PASSWORD="$DB_PASSWORD" \
+        "$IMAGE" > /dev/null
+    targets="${targets:+$targets,}localhost:$port"
+done
+
+for i in $(seq 0 $((COUNT - 1))); do
+    # 준비 대기
+    until docker exec "secs-pg-$i" pg_isready -U "$DB_USER" -d "$DB_NAME" > /dev/null 2>&1; do
+        sleep 1
+    done
+
+    for f in ${SCHEMA:+"$SCHEMA"} "$SQL_DIR"/*.sql; do
+        echo "secs-pg-$i: $(basename "$f")"
+        docker exec -i "secs-pg-$i" psql -q -v ON_ERROR_STOP=1 -U "$DB_USER" -d "$DB_NAME" < "$f"
+    done
+done
+
+echo ""
+echo "DB_TARGETS=$targets"
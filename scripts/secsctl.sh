@@ -0,0 +1,13 @@
+#!/bin/bash
+set -e
+
+# 제어 소켓 클라이언트
+#   ./scripts/secsctl.sh stats
+#   ./scripts/secsctl.sh workers 8
+SOCK=${CONTROL_SOCKET:-/tmp/secs-receiver.sock}
+
+if [ $# -eq 0 ]; then
+    set -- help
+fi
+
+echo "$*" | socat - UNIX-CONNECT:"$SOCK"
@@ -0,0 +1,16 @@
+-- RAW_RETENTION / RAW_COMPRESS_LEVEL 지원
+--   header / sample 정책: raw_body NULL 허용
+--   zlib 압축 보관: raw_body_z (BYTEA)
+--   none 정책: 파싱 테이블의 raw_message_id NULL 허용
+
+ALTER TABLE secs_raw_messages
+    ALTER COLUMN raw_body DROP NOT NULL,
+    ADD COLUMN IF NOT EXISTS raw_body_z BYTEA;
+
+COMMENT ON COLUMN secs_raw_messages.raw_body_z IS 'zlib 압축된 body JSON (raw_body가 NULL일 때)';
+
+ALTER TABLE s2f49_transfer_commands
+    ALTER COLUMN raw_message_id DROP NOT NULL;
+
+ALTER TABLE s6f11_event_reports
+    ALTER COLUMN raw_message_id DROP NOT NULL;
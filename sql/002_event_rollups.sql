@@ -0,0 +1,20 @@
+-- S6F11 윈도우 집계 (ROLLUP_WINDOW_SEC)
+--   item_name = ''  : 윈도우 내 이벤트 건수
+--   item_name = 이름 : 숫자형 data item 통계 (avg = value_sum / value_count)
+
+CREATE TABLE IF NOT EXISTS s6f11_event_rollups (
+    window_start  TIMESTAMPTZ      NOT NULL,
+    window_sec    INTEGER          NOT NULL,
+    device_id     INTEGER          NOT NULL,
+    event_id      INTEGER          NOT NULL,
+    item_name     TEXT             NOT NULL DEFAULT '',
+    event_count   BIGINT           NOT NULL,
+    value_count   BIGINT           NOT NULL DEFAULT 0,
+    value_min     DOUBLE PRECISION,
+    value_max     DOUBLE PRECISION,
+    value_sum     DOUBLE PRECISION,
+    PRIMARY KEY (window_start, device_id, event_id, item_name)
+);
+
+CREATE INDEX IF NOT EXISTS idx_s6f11_event_rollups_device
+    ON s6f11_event_rollups (device_id, window_start DESC);
@@ -1,20 +1,204 @@
 #include "config.h"
-#include "bounded_queue.h"
-#include "udp_receiver.h"
+#include "lane_queue.h"
+#include "receiver_factory.h"
+#include "per_core_engine.h"
 #include "worker_pool.h"
+#include "sharded_db_writer.h"
+#include "control_commands.h"
+#include "event_aggregator.h"
+#include "carrier_state_cache.h"
+#include "tracer.h"
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <csignal>
 #include <atomic>
 #include <thread>
+#include <memory>
 
 namespace {
     std::atomic<bool> g_shutdown{false};
+    std::atomic<bool> g_trace_dump{false};
     
     void signal_handler(int signal) {
         spdlog::info("종료 시그널 수신: {}", signal);
         g_shutdown = true;
     }
+
+    // SIGUSR1 → 메인 루프에서 trace 저장
+    void trace_signal_handler(int) {
+        g_trace_dump = true;
+    }
+
+    std::string trace_path(const secs::Config& config) {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        return config.trace_dir + "/trace-" + std::to_string(ms) + ".json";
+    }
+
+    // 명령행 옵션 (환경변수보다 우선)
+    //   --replay <file>  --replay-format <auto|pcap|raw>  --replay-speed <x>
+    void apply_args(int argc, char* argv[], secs::Config& config) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            std::string key = argv[i];
+            std::string val = argv[i + 1];
+            
+            if (key == "--replay") {
+                config.replay_file = val;
+            } else if (key == "--replay-format") {
+                config.replay_format = val;
+            } else if (key == "--replay-speed") {
+                config.replay_speed = std::stod(val);
+            } else {
+                throw std::invalid_argument("알 수 없는 옵션: " + key);
+            }
+        }
+    }
+
+    std::string arg_string(const secs::ControlServer::Args& args) {
+        if (args.empty()) {
+            throw std::invalid_argument("ID 인자 필요");
+        }
+        return args[0];
+    }
+
+    // 조회 소켓 명령 등록 (캐리어 / 반송 명령 최신 상태)
+    void register_query_commands(secs::ControlServer& query, const secs::CarrierStateCache& cache) {
+        using Args = secs::ControlServer::Args;
+        using secs::json;
+
+        query.on("carrier", [&cache](const Args& args) {
+            auto state = cache.find_carrier(arg_string(args));
+            return state ? json{{"found", true}, {"carrier", cache.to_json(*state)}}
+                         : json{{"found", false}};
+        });
+        query.on("command", [&cache](const Args& args) {
+            auto state = cache.find_command(arg_string(args));
+            return state ? json{{"found", true}, {"command", cache.to_json(*state)}}
+                         : json{{"found", false}};
+        });
+        query.on("stats", [&cache](const Args&) {
+            return cache.stats();
+        });
+    }
+
+    // 제어 소켓 명령 등록 (재시작 없이 튜닝 / 상태 조회)
+    // queue / worker_pool은 pipeline 모드, engine은 per_core 모드에서만 존재
+    void register_control_commands(secs::ControlServer& control,
+                                   secs::LaneQueue* queue,
+                                   secs::WorkerPool* worker_pool,
+                                   const secs::PerCoreEngine* engine,
+                                   const secs::RouteTable& routes,
+                                   const secs::EventAggregator* aggregator,
+                                   const secs::ShardedDbWriter* db_shards,
+                                   secs::Ingress& ingress,
+                                   secs::Receiver& receiver,
+                                   const secs::Config& config) {
+        using Args = secs::ControlServer::Args;
+        using secs::json;
+
+        control.on("stats", [&](const Args&) {
+            json stats = {
+                {"receiver", {
+                    {"backend", receiver.backend_name()},
+                    {"received", receiver.total_received()},
+                    {"bytes", receiver.total_bytes()},
+                    {"truncated", receiver.total_truncated()},
+                    {"queue_drops", ingress.total_queue_drops()}
+                }}
+            };
+            if (queue) {
+                stats["queue"] = {
+                    {"depth", queue->size()},
+                    {"capacity", queue->capacity()},
+                    {"lanes", queue->stats()}
+                };
+            }
+            if (worker_pool) {
+                stats["pool"] = worker_pool->stats();
+            }
+            if (engine) {
+                stats["per_core"] = engine->stats();
+            }
+            return stats;
+        });
+        control.on("loss", [&](const Args&) {
+            return ingress.loss_report();
+        });
+        secs::register_rate_limit_command(control, ingress.limiter());
+        control.on("acks", [&](const Args&) {
+            return ingress.acks().stats();
+        });
+        control.on("routes", [&](const Args&) {
+            return json{{"routes", routes.stats()}};
+        });
+        if (aggregator) {
+            control.on("rollup", [aggregator](const Args&) {
+                return aggregator->stats();
+            });
+        }
+        if (db_shards) {
+            control.on("shards", [db_shards](const Args&) {
+                return db_shards->stats();
+            });
+        }
+        if (worker_pool) {
+            control.on("workers", [worker_pool](const Args& args) {
+                return json{{"worker_count", worker_pool->resize(secs::arg_size(args, 1, 1024))}};
+            });
+            control.on("batch_size", [worker_pool](const Args& args) {
+                worker_pool->set_batch_size(secs::arg_size(args, 1, 100000));
+                return json{{"batch_size", worker_pool->batch_size()}};
+            });
+            control.on("batch_timeout_ms", [worker_pool](const Args& args) {
+                worker_pool->set_batch_timeout_ms(secs::arg_size(args, 1, 60000));
+                return json{{"batch_timeout_ms", worker_pool->batch_timeout_ms()}};
+            });
+        }
+        if (queue) {
+            // queue_capacity <n> [lane] (lane 생략 시 마지막 = 기본 lane)
+            control.on("queue_capacity", [queue](const Args& args) {
+                size_t lane = queue->lane_count() - 1;
+                if (args.size() > 1) {
+                    auto found = queue->find_lane(args[1]);
+                    if (!found) {
+                        throw std::invalid_argument("알 수 없는 lane: " + args[1]);
+                    }
+                    lane = *found;
+                }
+                queue->set_capacity(lane, secs::arg_size(args, 1, 100'000'000));
+                return json{{"lane", queue->lane_spec(lane).name}, {"queue_capacity", queue->capacity()}};
+            });
+            control.on("lanes", [queue](const Args&) {
+                return json{{"lanes", queue->stats()}};
+            });
+        }
+        control.on("trace", [&config](const Args& args) {
+            auto& tracer = secs::Tracer::instance();
+            std::string sub = args.empty() ? "" : args[0];
+            if (sub == "on" || sub == "off") {
+                tracer.set_enabled(sub == "on");
+                return json{{"trace", sub}};
+            }
+            if (sub == "dump") {
+                std::string path = args.size() > 1 ? args[1] : trace_path(config);
+                size_t events = tracer.dump(path);
+                return json{{"path", path}, {"events", events}};
+            }
+            throw std::invalid_argument("on|off|dump [path]");
+        });
+        control.on("log_level", [](const Args& args) {
+            if (args.empty()) {
+                throw std::invalid_argument("trace|debug|info|warn|error|critical|off");
+            }
+            // from_str는 모르는 이름을 off로 바꾸므로 오타가 로그 전체를 끄지 않도록 거부
+            auto level = spdlog::level::from_str(args[0]);
+            if (level == spdlog::level::off && args[0] != "off") {
+                throw std::invalid_argument("알 수 없는 log level: " + args[0]);
+            }
+            spdlog::set_level(level);
+            return json{{"log_level", spdlog::level::to_string_view(spdlog::get_level()).data()}};
+        });
+    }
 }
 
 int main(int argc, char* argv[]) {
@@ -32,55 +216,194 @@ int main(int argc, char* argv[]) {
     // 시그널 핸들러 등록
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
+    std::signal(SIGUSR1, trace_signal_handler);
     
     try {
         // 설정 로드
         auto config = secs::Config::from_env();
+        apply_args(argc, argv, config);
         
         spdlog::info("설정:");
-        spdlog::info("  UDP: {}:{}", config.udp_host, config.udp_port);
-        spdlog::info("  DB:  {}:{}/{}", config.db_host, config.db_port, config.db_name);
-        spdlog::info("  성능: Queue={}, Workers={}, Batch={}, Timeout={}ms",
-                    config.queue_capacity, config.worker_count, 
-                    config.batch_size, config.batch_timeout_ms);
-        
-        // 메시지 큐 생성
-        secs::BoundedQueue<secs::RawMessage> queue(config.queue_capacity);
-        spdlog::info("메시지 큐 생성 완료 (capacity={})", config.queue_capacity);
-        
-        // Worker Pool 시작
-        secs::WorkerPool worker_pool(config, queue);
-        worker_pool.start();
-        
-        // UDP 수신 시작 (별도 스레드)
-        secs::UdpReceiver receiver(config, queue);
+        if (config.replay_file.empty()) {
+            spdlog::info("  UDP: {}:{} (backend={})", config.udp_host, config.udp_port, config.recv_backend);
+        } else {
+            spdlog::info("  Replay: {} (format={}, speed={})", 
+                        config.replay_file, config.replay_format, config.replay_speed);
+        }
+        bool sharded = !config.db_targets.empty() &&
+                       ("," + config.sinks + ",").find(",postgres,") != std::string::npos;
+        if (sharded) {
+            // 샤드 기록은 비동기이므로 "커밋 후 응답"을 보장할 수 없다
+            if (config.s2f50_ack == "commit") {
+                throw std::invalid_argument("S2F50_ACK=commit은 DB_TARGETS 샤딩과 함께 사용할 수 없음");
+            }
+            spdlog::info("  DB:  shards={} (writers/shard={})", config.db_targets, config.db_pool_size);
+        } else {
+            spdlog::info("  DB:  {}:{}/{}", config.db_host, config.db_port, config.db_name);
+        }
+        bool per_core = config.exec_mode == "per_core";
+        if (per_core) {
+            if (!config.replay_file.empty()) {
+                throw std::invalid_argument("EXEC_MODE=per_core는 캡처 재생을 지원하지 않음");
+            }
+            spdlog::info("  성능: per-core (Cores={}), Batch={}, Timeout={}ms",
+                        config.core_count ? std::to_string(config.core_count) : "auto",
+                        config.batch_size, config.batch_timeout_ms);
+        } else if (config.exec_mode == "pipeline") {
+            spdlog::info("  성능: Queue={}, Workers={}, Batch={}, Timeout={}ms",
+                        config.queue_capacity, config.worker_count, 
+                        config.batch_size, config.batch_timeout_ms);
+        } else {
+            throw std::invalid_argument("알 수 없는 EXEC_MODE: " + config.exec_mode);
+        }
+        
+        // 추적 (선택, 런타임에 제어 명령으로도 전환 가능)
+        secs::Tracer::instance().configure(config.trace_buffer_events);
+        if (config.trace_enabled) {
+            secs::Tracer::instance().set_enabled(true);
+        }
+        
+        // 메시지 큐 생성 (pipeline 모드)
+        std::unique_ptr<secs::LaneQueue> queue;
+        if (!per_core) {
+            queue = std::make_unique<secs::LaneQueue>(config.queue_lanes, config.queue_capacity);
+            for (size_t i = 0; i < queue->lane_count(); ++i) {
+                const auto& lane = queue->lane_spec(i);
+                spdlog::info("메시지 큐 lane '{}' (capacity={}, weight={}, batch_timeout={}ms)",
+                            lane.name, lane.capacity, lane.weight, lane.batch_timeout_ms);
+            }
+        }
+        
+        // 헤더 기반 라우팅 규칙
+        secs::RouteTable routes(config.route_rules);
+        
+        // S6F11 윈도우 집계 (선택)
+        std::unique_ptr<secs::EventAggregator> aggregator;
+        if (config.rollup_window_sec > 0) {
+            aggregator = std::make_unique<secs::EventAggregator>(config);
+            aggregator->start();
+        }
+        
+        // 캐리어 상태 캐시 + 조회 소켓 (선택)
+        std::unique_ptr<secs::CarrierStateCache> state_cache;
+        std::unique_ptr<secs::ControlServer> query;
+        if (!config.query_socket.empty()) {
+            state_cache = std::make_unique<secs::CarrierStateCache>(config);
+            state_cache->start();
+            query = std::make_unique<secs::ControlServer>(config.query_socket);
+            register_query_commands(*query, *state_cache);
+            query->start();
+        }
+        
+        // DB 샤드 writer (선택, 워커 / 코어 sink가 공유)
+        std::shared_ptr<secs::ShardedDbWriter> db_shards;
+        if (sharded) {
+            db_shards = secs::ShardedDbWriter::shared(config);
+            db_shards->set_state_cache(state_cache.get());
+        }
+        
+        // 수신 입구 (손실 집계 / 수신 제한 / S2F50 응답 소켓)
+        secs::Ingress ingress(config, queue.get());
+        
+        // Worker Pool 시작 (pipeline 모드)
+        std::unique_ptr<secs::WorkerPool> worker_pool;
+        if (queue) {
+            worker_pool = std::make_unique<secs::WorkerPool>(config, *queue, routes);
+            worker_pool->set_aggregator(aggregator.get());
+            worker_pool->set_state_cache(state_cache.get());
+            worker_pool->set_ack_sender(&ingress.acks());
+            worker_pool->start();
+        }
+        
+        // UDP 수신 시작 (별도 스레드, per_core 모드는 코어별 수신 + 처리 스레드)
+        std::unique_ptr<secs::Receiver> receiver;
+        secs::PerCoreEngine* engine = nullptr;
+        if (per_core) {
+            auto core_engine = std::make_unique<secs::PerCoreEngine>(
+                config, ingress, routes, aggregator.get(), state_cache.get());
+            engine = core_engine.get();
+            receiver = std::move(core_engine);
+        } else {
+            receiver = secs::make_receiver(config, ingress);
+        }
 		std::thread udp_thread([&receiver]() {
-    		receiver.start();
+    		receiver->start();
 		});
         
-        spdlog::info("SECS UDP Receiver 시작 완료");
+        // 제어 소켓 (선택)
+        std::unique_ptr<secs::ControlServer> control;
+        if (!config.control_socket.empty()) {
+            control = std::make_unique<secs::ControlServer>(config.control_socket);
+            register_control_commands(*control, queue.get(), worker_pool.get(), engine, routes, 
+                                      aggregator.get(), db_shards.get(), ingress, *receiver, config);
+            control->start();
+        }
+        
+        spdlog::info("SECS UDP Receiver 시작 완료 (수신 엔진: {})", receiver->backend_name());
  		spdlog::info(separator);
         
-        // 종료 시그널 대기
-        while (!g_shutdown) {
+        // 종료 시그널 대기 (캡처 재생은 입력 종료 시 자동 종료)
+        while (!g_shutdown && !receiver->finished()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (g_trace_dump.exchange(false)) {
+                try {
+                    secs::Tracer::instance().dump(trace_path(config));
+                }
+                catch (const std::exception& e) {
+                    spdlog::error("trace 저장 실패: {}", e.what());
+                }
+            }
         }
         
  		spdlog::info(separator);
         spdlog::info("종료 중...");
         
         // 그레이스풀 종료
+        if (control) {
+            control->stop();
+        }
+        if (query) {
+            query->stop();
+        }
 		// 1. UDP 수신 중단
-		receiver.stop();
+		receiver->stop();
 		// 2. queue close
-        queue.close();
-		// 3. Worker Pool stop
-        worker_pool.stop();
-
-		// 4. UDP thread join
+        if (queue) {
+            queue->close();
+        }
+		// 3. Worker Pool stop (큐에 남은 메시지까지 처리 후 종료)
+        if (worker_pool) {
+            worker_pool->stop();
+        }
+		// 4. UDP thread join (per_core 모드는 코어별 남은 배치 처리 후 반환)
         if (udp_thread.joinable()) {
             udp_thread.join();
         }
+        // DB 샤드 큐에 남은 하위 배치 기록
+        if (db_shards) {
+            db_shards->stop();
+        }
+		// 5. 집계 flush (열린 윈도우 포함)
+        if (aggregator) {
+            aggregator->stop();
+        }
+        // 상태 캐시 최종 스냅샷
+        if (state_cache) {
+            state_cache->stop();
+        }
+        
+        uint64_t received = receiver->total_received();
+        if (received > 0) {
+            spdlog::info("수신 통계 ({}): {}건, syscalls/packet={:.3f}, CPU/packet={}ns",
+                        receiver->backend_name(), received,
+                        double(receiver->total_syscalls()) / received,
+                        receiver->cpu_time_ns() / received);
+        }
+        auto loss = ingress.loss_report()["loss"];
+        spdlog::info("손실 통계: {}", loss.dump());
+        if (ingress.acks().enabled()) {
+            spdlog::info("S2F50 응답 통계: {}", ingress.acks().stats().dump());
+        }
         
         spdlog::info("SECS UDP Receiver 종료 완료");
         
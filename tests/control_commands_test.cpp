@@ -0,0 +1,66 @@
+// 제어 명령 인자 검증: 음수 / 잔여 문자 / 범위 초과 입력은 거부하고 limiter 상태를 바꾸지 않는다
+#include "control_commands.h"
+#include <cstdio>
+#include <cstdlib>
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK 실패: %s\n", __FILE__, __LINE__, #cond); std::exit(1); } } while (0)
+
+namespace {
+
+bool ok(const secs::ControlServer& control, const std::string& line) {
+    return nlohmann::json::parse(control.execute(line))["ok"].get<bool>();
+}
+
+} // namespace
+
+int main() {
+    secs::DeviceRateLimiter limiter(0, 0, "", 1024);
+    secs::ControlServer control("/tmp/secs-control-test.sock");  // start() 없이 execute()만 사용
+    secs::register_rate_limit_command(control, limiter);
+
+    // 거부되는 입력 (핸들러 밖으로 예외가 새지 않고 ok=false)
+    for (const char* line : {
+             "rate_limit 17 -1",
+             "rate_limit 17 12abc",
+             "rate_limit 17 +5",
+             "rate_limit 17 99999999999999999999",
+             "rate_limit 17 100 -2",
+             "rate_limit abc 5",
+             "rate_limit -17 5",
+             "rate_limit 17x clear",
+             "rate_limit default -5",
+             "rate_limit default 5 x",
+             "rate_limit 17",
+         }) {
+        CHECK(!ok(control, line));
+    }
+    CHECK(!limiter.enabled());
+    CHECK(limiter.stats()["rate"] == 0);
+    CHECK(limiter.stats()["devices"].empty());
+
+    // 정상 입력
+    CHECK(ok(control, "rate_limit 17 100 200"));
+    CHECK(limiter.enabled());
+    CHECK(ok(control, "rate_limit 17 clear"));
+    CHECK(!limiter.enabled());
+    CHECK(ok(control, "rate_limit default 50"));
+    CHECK(limiter.stats()["rate"] == 50);
+    CHECK(ok(control, "rate_limit"));
+
+    // 다른 숫자 인자 명령과 같은 파서
+    CHECK(secs::parse_arg<size_t>("42", 1, 100) == 42);
+    for (const char* s : {"", "0", "101", "-1", "+1", "1.5", " 1", "1 "}) {
+        bool threw = false;
+        try {
+            secs::parse_arg<size_t>(s, 1, 100);
+        }
+        catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+
+    std::printf("control_commands_test: OK\n");
+    return 0;
+}
@@ -0,0 +1,84 @@
+// S6F11 rollup: flush 실패 후 같은 윈도우에 늦은 이벤트가 오면 한 번의 기록에서 병합되는지 확인
+#include "event_aggregator.h"
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK 실패: %s\n", __FILE__, __LINE__, #cond); std::exit(1); } } while (0)
+
+namespace {
+
+secs::S6F11Message event(double temp) {
+    secs::S6F11Message msg;
+    msg.timestamp = "2020-01-01T00:00:05Z";  // 이미 닫힌 윈도우
+    msg.device_id = 17;
+    msg.event_id = 100;
+    msg.data_items = secs::json::array({{{"name", "TEMP"}, {"value", temp}}});
+    return msg;
+}
+
+template<typename Pred>
+bool wait_for(Pred pred) {
+    for (int i = 0; i < 500 && !pred(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return pred();
+}
+
+} // namespace
+
+int main() {
+    setenv("ROLLUP_WINDOW_SEC", "60", 1);
+    setenv("ROLLUP_FLUSH_MS", "20", 1);
+    setenv("ROLLUP_GRACE_SEC", "0", 1);
+    auto cfg = secs::Config::from_env();
+
+    using Row = secs::EventAggregator::RollupRow;
+    std::mutex mutex;
+    int failures = 0;
+    bool late_added = false;  // 늦은 이벤트 추가 전까지 DB 장애 유지
+    std::vector<Row> written;
+
+    secs::EventAggregator aggregator(cfg);
+    aggregator.set_writer([&](const std::vector<Row>& rows) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!late_added) {
+            failures++;
+            throw std::runtime_error("DB 장애 (테스트)");
+        }
+        written.insert(written.end(), rows.begin(), rows.end());
+    });
+
+    aggregator.add(event(20.0));
+    aggregator.start();
+    CHECK(wait_for([&] { std::lock_guard<std::mutex> lock(mutex); return failures >= 1; }));
+
+    // 보류 중인 윈도우에 늦게 도착한 이벤트
+    aggregator.add(event(30.0));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        late_added = true;
+    }
+    CHECK(wait_for([&] { std::lock_guard<std::mutex> lock(mutex); return !written.empty(); }));
+    aggregator.stop();
+
+    // 키마다 row 하나 (이벤트 건수 + TEMP)
+    CHECK(written.size() == 2);
+    for (const auto& r : written) {
+        CHECK(r.device_id == 17 && r.event_id == 100);
+        CHECK(r.event_count == 2);
+        if (r.item_name == "TEMP") {
+            CHECK(r.value_count == 2);
+            CHECK(r.value_min == 20.0);
+            CHECK(r.value_max == 30.0);
+            CHECK(r.value_sum == 50.0);
+        } else {
+            CHECK(r.item_name.empty());
+            CHECK(r.value_count == 0);
+        }
+    }
+
+    std::printf("event_aggregator_test: OK\n");
+    return 0;
+}
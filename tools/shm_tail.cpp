@@ -0,0 +1,99 @@
+// 공유 메모리 ring 소비자 예제 (include/shm_ring.h만 사용, 수신기 의존성 없음)
+// 구독한 (stream, function) 레코드를 한 줄씩 출력하고, 추월당하면 유실 건수를 알린다.
+//
+// 사용법: shm-tail [name=/secs-ring] [S/F ...]     예) shm-tail /secs-ring 2/49 6/*
+
+#include "shm_ring.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+uint64_t monotonic_ns() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ull + ts.tv_nsec;
+}
+
+void print(const secs::shm::Record& r) {
+    using secs::shm::field;
+    double age_us = r.recv_ns ? double(monotonic_ns() - r.recv_ns) / 1000.0 : 0.0;
+    std::printf("#%llu S%uF%u dev=%d sb=%.*s age=%.1fus",
+                static_cast<unsigned long long>(r.seq), r.stream, r.function, r.device_id,
+                static_cast<int>(field(r.system_bytes).size()), r.system_bytes, age_us);
+
+    if (r.kind == secs::shm::kS2F49) {
+        auto cmd = field(r.s2f49.command_id);
+        auto carrier = field(r.s2f49.carrier_id);
+        auto src = field(r.s2f49.source);
+        auto dst = field(r.s2f49.dest);
+        std::printf(" cmd=%.*s carrier=%.*s %.*s->%.*s",
+                    int(cmd.size()), cmd.data(), int(carrier.size()), carrier.data(),
+                    int(src.size()), src.data(), int(dst.size()), dst.data());
+    }
+    else if (r.kind == secs::shm::kS6F11) {
+        auto items = r.payload();
+        std::printf(" ceid=%d rptid=%d items=%.*s%s",
+                    r.s6f11.event_id, r.s6f11.event_report_id,
+                    int(items.size()), items.data(), r.truncated ? "..." : "");
+    }
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string name = argc > 1 ? argv[1] : "/secs-ring";
+    std::signal(SIGINT, [](int) { g_stop = 1; });
+    std::signal(SIGTERM, [](int) { g_stop = 1; });
+
+    try {
+        // 생산자가 ring을 교체하면 같은 구독으로 다시 attach
+        auto attach = [&]() {
+            auto reader = std::make_unique<secs::shm::RingReader>(name);
+            for (int i = 2; i < argc; ++i) {
+                std::string sf = argv[i];
+                auto slash = sf.find('/');
+                auto num = [](const std::string& s) { return s == "*" ? -1 : std::stoi(s); };
+                reader->subscribe(num(sf.substr(0, slash)),
+                                  slash == std::string::npos ? -1 : num(sf.substr(slash + 1)));
+            }
+            std::fprintf(stderr, "attach %s (slots=%u, next=%llu)\n", name.c_str(), reader->slot_count(),
+                         static_cast<unsigned long long>(reader->next_seq()));
+            return reader;
+        };
+        auto reader = attach();
+
+        while (!g_stop) {
+            // 출력 중 덮어쓰기는 Overrun으로 알려지므로 한 줄이 깨질 수 있다 (예제용)
+            switch (reader->read(print)) {
+                case secs::shm::ReadStatus::Ok:
+                    break;
+                case secs::shm::ReadStatus::Empty:
+                    std::fflush(stdout);
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                    break;
+                case secs::shm::ReadStatus::Overrun:
+                    std::fprintf(stderr, "overrun: 누적 유실 %llu건\n",
+                                 static_cast<unsigned long long>(reader->lost()));
+                    break;
+                case secs::shm::ReadStatus::Replaced:
+                    std::fprintf(stderr, "ring 교체됨 - 다시 attach\n");
+                    reader = attach();
+                    break;
+            }
+        }
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "오류: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}